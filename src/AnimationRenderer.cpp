@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "AnimationRenderer.h"
+
+AnimationRenderer::AnimationRenderer(Scene* scene, const RayTracer& rayTracer)
+{
+	init(scene, rayTracer);
+}
+
+std::string AnimationRenderer::getFrameFileName(const std::string& pattern, int frame)
+{
+	size_t percent = pattern.find('%');
+	size_t conversion = pattern.find('d', percent);
+
+	if (percent != std::string::npos && conversion != std::string::npos)
+	{
+		std::string format = pattern.substr(percent, conversion - percent + 1);
+		char number[32];
+		std::snprintf(number, sizeof(number), format.c_str(), frame);
+
+		return pattern.substr(0, percent) + number + pattern.substr(conversion + 1);
+	}
+
+	char number[32];
+	std::snprintf(number, sizeof(number), "_%04d", frame);
+
+	size_t dot = pattern.find_last_of('.');
+	if (dot == std::string::npos)
+	{
+		return pattern + number;
+	}
+
+	return pattern.substr(0, dot) + number + pattern.substr(dot);
+}
+
+int AnimationRenderer::getFrameCount(const CameraPath& path, double framesPerSecond)
+{
+	if (path.getKeyframes().empty() || framesPerSecond <= 0.0)
+	{
+		return 0;
+	}
+
+	return static_cast<int>(std::floor((path.getEndTime() - path.getStartTime()) * framesPerSecond + 1e-6)) + 1;
+}
+
+int AnimationRenderer::getParallelFrames(int frameCount) const
+{
+	//frames in flight scale better than tiles, there is no per frame setup or tail of unbalanced tiles,
+	//so by default every thread gets its own frame and threads only team up on the last frames
+	int parallelFrames = m_parallelFrames > 0 ? m_parallelFrames : m_threadCount;
+
+	return std::max(1, std::min(parallelFrames, frameCount));
+}
+
+void AnimationRenderer::init(Scene* scene, const RayTracer& rayTracer)
+{
+	m_scene = scene;
+	m_rayTracerSettings = rayTracer.toDescription();
+}
+
+void AnimationRenderer::setRenderListener(RenderListener* renderListener)
+{
+	m_renderListener = renderListener;
+}
+
+void AnimationRenderer::setSize(int width, int height)
+{
+	m_width = width;
+	m_height = height;
+}
+
+void AnimationRenderer::setThreadCount(int threadCount)
+{
+	m_threadCount = std::max(1, threadCount);
+}
+
+void AnimationRenderer::setParallelFrames(int parallelFrames)
+{
+	m_parallelFrames = std::max(0, parallelFrames);
+}
+
+void AnimationRenderer::setSamples(int samples)
+{
+	m_samples = std::max(1, samples);
+}
+
+void AnimationRenderer::setNoiseThreshold(double threshold)
+{
+	m_noiseThreshold = threshold;
+}
+
+int AnimationRenderer::render(const CameraPath& path, double framesPerSecond, const std::string& outputPattern)
+{
+	m_cancellationToken.reset();
+
+	int frameCount = getFrameCount(path, framesPerSecond);
+	if (m_scene == nullptr || m_scene->getCamera() == nullptr || frameCount == 0)
+	{
+		return frameCount;
+	}
+
+	int parallelFrames = getParallelFrames(frameCount);
+
+	std::atomic<int> nextFrame(0);
+	std::atomic<int> failedFrames(0);
+
+	//every slot renders one frame at a time with its own ray tracer and camera, the scene and its compiled form are shared
+	CompiledScene compiledScene(*m_scene);
+
+	auto renderFrames = [&]()
+	{
+		std::unique_ptr<Camera> camera = m_scene->getCamera()->clone();
+
+		RayTracer rayTracer(m_width, m_height, m_scene, camera.get());
+		rayTracer.set(m_rayTracerSettings);
+		rayTracer.setPreviewMode(false);
+		rayTracer.setTemporalReprojection(false);
+		rayTracer.setRefinementMaxSamples(m_samples);
+		rayTracer.setRefinementNoiseThreshold(m_noiseThreshold);
+		rayTracer.setRefinementUpdateInterval(m_samples);
+
+		//a cancel that comes before the ray tracer is registered is still seen by the check before the first frame
+		{
+			std::lock_guard<std::mutex> lock(m_activeRayTracersMutex);
+			m_activeRayTracers.push_back(&rayTracer);
+		}
+
+		for (int frame = nextFrame++; frame < frameCount; frame = nextFrame++)
+		{
+			if (m_cancellationToken.isCancelled())
+			{
+				break;
+			}
+
+			std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+			//once fewer frames than slots are left, the idle threads are handed to the remaining frames
+			int framesLeft = std::min(parallelFrames, frameCount - frame);
+			rayTracer.setThreadCount(std::max(1, m_threadCount / framesLeft));
+
+			path.apply(path.getStartTime() + frame / framesPerSecond, *camera);
+
+			rayTracer.render(compiledScene);
+
+			if (m_samples > 1)
+			{
+				rayTracer.refine(compiledScene);
+			}
+
+			//a frame stopped halfway is neither saved nor reported
+			if (m_cancellationToken.isCancelled())
+			{
+				break;
+			}
+
+			bool saved = false;
+			rayTracer.readFrontImage([&](const Image& image)
+			{
+				saved = image.save(getFrameFileName(outputPattern, frame));
+			});
+
+			if (!saved)
+			{
+				failedFrames++;
+			}
+
+			std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+			if (m_renderListener != nullptr)
+			{
+				m_renderListener->onFrameFinished(frame, static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count()), saved);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(m_activeRayTracersMutex);
+		m_activeRayTracers.erase(std::find(m_activeRayTracers.begin(), m_activeRayTracers.end(), &rayTracer));
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < parallelFrames; ++i)
+	{
+		threads.emplace_back(renderFrames);
+	}
+
+	renderFrames();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	return failedFrames;
+}
+
+void AnimationRenderer::cancelRendering()
+{
+	m_cancellationToken.cancel();
+
+	std::lock_guard<std::mutex> lock(m_activeRayTracersMutex);
+	for (RayTracer* rayTracer : m_activeRayTracers)
+	{
+		rayTracer->cancelRendering();
+	}
+}
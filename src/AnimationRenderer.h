@@ -0,0 +1,77 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CameraPath.h"
+#include "CancellationToken.h"
+#include "RayTracer.h"
+#include "RenderListener.h"
+#include "Scene.h"
+
+//renders a camera path frame by frame, several frames are in flight at once and share the same scene
+class AnimationRenderer
+{
+private:
+
+	Scene* m_scene = nullptr;
+	RenderListener* m_renderListener = nullptr;
+	std::string m_rayTracerSettings;
+	int m_width = 1280;
+	int m_height = 720;
+	int m_threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	int m_parallelFrames = 0;
+	int m_samples = 1;
+	double m_noiseThreshold = 0.0;
+	CancellationToken m_cancellationToken;
+
+	//the ray tracers of the frame slots that are rendering, so a cancel also stops the frames in flight
+	std::vector<RayTracer*> m_activeRayTracers;
+	std::mutex m_activeRayTracersMutex;
+
+public:
+
+	AnimationRenderer() = default;
+
+	//the scene is only read while rendering, the render settings are copied from the ray tracer
+	AnimationRenderer(Scene* scene, const RayTracer& rayTracer);
+
+	AnimationRenderer(const AnimationRenderer& other) = delete;
+
+	AnimationRenderer(AnimationRenderer&& other) = delete;
+
+	AnimationRenderer& operator=(const AnimationRenderer& other) = delete;
+
+	AnimationRenderer& operator=(AnimationRenderer&& other) = delete;
+
+	~AnimationRenderer() = default;
+
+	//replaces the first printf style integer conversion in the pattern by the frame number,
+	//or appends the frame number before the extension if there is none
+	static std::string getFrameFileName(const std::string& pattern, int frame);
+
+	static int getFrameCount(const CameraPath& path, double framesPerSecond);
+
+	int getParallelFrames(int frameCount) const;
+
+	void init(Scene* scene, const RayTracer& rayTracer);
+
+	void setRenderListener(RenderListener* renderListener);
+
+	void setSize(int width, int height);
+
+	void setThreadCount(int threadCount);
+
+	//0 picks the number of frames in flight from the thread count
+	void setParallelFrames(int parallelFrames);
+
+	void setSamples(int samples);
+
+	void setNoiseThreshold(double threshold);
+
+	//returns the number of frames that could not be saved
+	int render(const CameraPath& path, double framesPerSecond, const std::string& outputPattern);
+
+	void cancelRendering();
+};
@@ -26,7 +26,7 @@ void Application::init(int& argc, char* argv[])
 	m_settingsWindow = std::make_unique<SettingsWindow>();
 
 	m_rayTracer.init(&m_scene, m_scene.getCamera());
-	m_concurrencyHandler.init(&m_rayTracer);
+	m_concurrencyHandler.init(&m_rayTracer, &m_scene);
 	m_keyEventHandler.init(m_scene.getCamera());
 	m_mouseEventHandler.init(m_scene.getCamera());
 	m_mainWindow->installEventFilter(&m_keyEventHandler);
@@ -38,6 +38,8 @@ void Application::init(int& argc, char* argv[])
 
 	QObject::connect(&m_concurrencyHandler, &ConcurrencyHandler::renderPreviewFinished, m_mainWindow.get(), &MainWindow::onRenderPreviewFinished);
 	QObject::connect(&m_concurrencyHandler, &ConcurrencyHandler::renderFinished, m_mainWindow.get(), &MainWindow::onRenderFinished);
+	QObject::connect(&m_concurrencyHandler, &ConcurrencyHandler::refinementFinished, m_mainWindow.get(), &MainWindow::onRefinementFinished);
+	QObject::connect(&m_concurrencyHandler, &ConcurrencyHandler::renderCancelled, m_mainWindow.get(), &MainWindow::onRenderCancelled);
 
 	QObject::connect(&m_keyEventHandler, &KeyEventHandler::cameraMoving, m_mainWindow.get(), &MainWindow::onCameraMoving);
 	QObject::connect(&m_keyEventHandler, &KeyEventHandler::cameraMoving, m_settingsWindow.get(), &SettingsWindow::on_cameraPosChanged);
@@ -45,8 +47,13 @@ void Application::init(int& argc, char* argv[])
 
 	QObject::connect(&m_mouseEventHandler, &MouseEventHandler::cameraRotating, m_mainWindow.get(), &MainWindow::onCameraRotating);
 	QObject::connect(&m_mouseEventHandler, &MouseEventHandler::cameraRotatingStopped, m_mainWindow.get(), &MainWindow::onCameraRotatingStopped);
+	QObject::connect(&m_mouseEventHandler, &MouseEventHandler::regionOfInterestChanged, [](int x, int y) { m_rayTracer.setRegionOfInterest(x, y); });
 
-	QObject::connect(&m_rayTracer, &RayTracer::lineFinished, m_mainWindow.get(), &MainWindow::onLineFinished);
+	QObject::connect(m_mainWindow.get(), &MainWindow::sceneLoaded, &m_concurrencyHandler, &ConcurrencyHandler::onSceneChanged);
+	QObject::connect(m_settingsWindow.get(), &SettingsWindow::sceneChanged, &m_concurrencyHandler, &ConcurrencyHandler::onSceneChanged);
+	QObject::connect(m_settingsWindow.get(), &SettingsWindow::sceneChanged, m_mainWindow.get(), &MainWindow::onRedraw);
+
+	QObject::connect(&m_concurrencyHandler, &ConcurrencyHandler::refinementUpdated, m_mainWindow.get(), &MainWindow::onRefinementUpdated);
 }
 
 int Application::run()
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "Vector.h"
 #include "Ray.h"
 #include "EntityDescriptionInterface.h"
@@ -31,6 +33,9 @@ public:
 
 	virtual Ray getRay(int screenWidth, int screenHeight, double x, double y) const = 0;
 
+	//inverse of getRay, returns false if the point is behind the camera
+	virtual bool project(int screenWidth, int screenHeight, const Vector& point, double& x, double& y) const = 0;
+
 	virtual std::unique_ptr<Camera> clone() const = 0;
 
 	void setPosition(const Vector& position);
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "CameraPath.h"
+#include "Utility.h"
+
+std::string CameraPath::KEYFRAME_LABEL = "Keyframe";
+
+bool CameraPath::load(const std::string& fileName)
+{
+	std::ifstream ifs(fileName);
+
+	if (!ifs.is_open())
+	{
+		return false;
+	}
+
+	m_keyframes.clear();
+
+	std::string line;
+
+	try
+	{
+		while (std::getline(ifs, line))
+		{
+			std::vector<std::string> list = Utility::split(line, ',');
+
+			if (list.size() < 11 || list[0] != KEYFRAME_LABEL)
+			{
+				continue;
+			}
+
+			addKeyframe(std::stod(list[1]),
+				Vector(std::stod(list[2]), std::stod(list[3]), std::stod(list[4])),
+				Vector(std::stod(list[5]), std::stod(list[6]), std::stod(list[7])),
+				Vector(std::stod(list[8]), std::stod(list[9]), std::stod(list[10])));
+		}
+	}
+	catch (const std::exception&)
+	{
+		m_keyframes.clear();
+		return false;
+	}
+
+	return !m_keyframes.empty();
+}
+
+bool CameraPath::save(const std::string& fileName) const
+{
+	std::ofstream ofs(fileName);
+
+	if (!ofs.is_open())
+	{
+		return false;
+	}
+
+	for (const CameraKeyframe& keyframe : m_keyframes)
+	{
+		Matrix rotation = keyframe.m_orientation.getMatrix();
+		Vector direction = -(rotation * Vector(0, 0, 1));
+		Vector up = rotation * Vector(0, 1, 0);
+
+		ofs << KEYFRAME_LABEL << ","
+			<< keyframe.m_time << ","
+			<< keyframe.m_position.m_x << ","
+			<< keyframe.m_position.m_y << ","
+			<< keyframe.m_position.m_z << ","
+			<< direction.m_x << ","
+			<< direction.m_y << ","
+			<< direction.m_z << ","
+			<< up.m_x << ","
+			<< up.m_y << ","
+			<< up.m_z << "\n";
+	}
+
+	return true;
+}
+
+void CameraPath::addKeyframe(double time, const Vector& position, const Vector& direction, const Vector& up)
+{
+	//the up vector only has to point roughly up, the basis is made orthonormal here
+	Vector back = -normalize(direction);
+	Vector right = normalize(cross(direction, up));
+	Vector orthoUp = cross(back, right);
+
+	CameraKeyframe keyframe{ time, position, Quaternion::fromBasis(right, orthoUp, back) };
+
+	auto it = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), time, 
+		[](double t, const CameraKeyframe& k) { return t < k.m_time; });
+	m_keyframes.insert(it, keyframe);
+}
+
+void CameraPath::addKeyframe(double time, const Camera& camera)
+{
+	addKeyframe(time, camera.getPosition(), camera.getDirection(), camera.getUp());
+}
+
+const std::vector<CameraKeyframe>& CameraPath::getKeyframes() const
+{
+	return m_keyframes;
+}
+
+double CameraPath::getStartTime() const
+{
+	return m_keyframes.empty() ? 0.0 : m_keyframes.front().m_time;
+}
+
+double CameraPath::getEndTime() const
+{
+	return m_keyframes.empty() ? 0.0 : m_keyframes.back().m_time;
+}
+
+void CameraPath::apply(double time, Camera& camera) const
+{
+	if (m_keyframes.empty())
+	{
+		return;
+	}
+
+	int last = static_cast<int>(m_keyframes.size()) - 1;
+
+	//index of the keyframe that starts the segment containing the time
+	int i = static_cast<int>(std::upper_bound(m_keyframes.begin(), m_keyframes.end(), time,
+		[](double t, const CameraKeyframe& k) { return t < k.m_time; }) - m_keyframes.begin()) - 1;
+	i = std::max(0, std::min(i, last));
+	int j = std::min(i + 1, last);
+
+	double duration = m_keyframes[j].m_time - m_keyframes[i].m_time;
+	double t = duration > 0.0 ? std::max(0.0, std::min(1.0, (time - m_keyframes[i].m_time) / duration)) : 0.0;
+
+	const Vector& p0 = m_keyframes[std::max(i - 1, 0)].m_position;
+	const Vector& p1 = m_keyframes[i].m_position;
+	const Vector& p2 = m_keyframes[j].m_position;
+	const Vector& p3 = m_keyframes[std::min(j + 1, last)].m_position;
+
+	double t2 = t * t;
+	double t3 = t2 * t;
+	Vector position = 0.5 * ((2.0 * p1) 
+		+ (p2 - p0) * t 
+		+ (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3) * t2 
+		+ (3.0 * p1 - p0 - 3.0 * p2 + p3) * t3);
+
+	Matrix rotation = Quaternion::slerp(m_keyframes[i].m_orientation, m_keyframes[j].m_orientation, t).getMatrix();
+
+	camera.setPosition(position);
+	camera.setRight(normalize(rotation * Vector(1, 0, 0)));
+	camera.setUp(normalize(rotation * Vector(0, 1, 0)));
+	camera.setDirection(-normalize(rotation * Vector(0, 0, 1)));
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Camera.h"
+#include "Quaternion.h"
+#include "Vector.h"
+
+struct CameraKeyframe
+{
+	double m_time;
+	Vector m_position;
+	Quaternion m_orientation;
+};
+
+class CameraPath
+{
+private:
+
+	std::vector<CameraKeyframe> m_keyframes;
+
+public:
+
+	static std::string KEYFRAME_LABEL;
+
+	CameraPath() = default;
+
+	CameraPath(const CameraPath& other) = default;
+
+	CameraPath(CameraPath&& other) = default;
+
+	CameraPath& operator=(const CameraPath& other) = default;
+
+	CameraPath& operator=(CameraPath&& other) = default;
+
+	~CameraPath() = default;
+
+	//one "Keyframe,time,posX,posY,posZ,dirX,dirY,dirZ,upX,upY,upZ" line per keyframe, in any order
+	bool load(const std::string& fileName);
+
+	bool save(const std::string& fileName) const;
+
+	void addKeyframe(double time, const Vector& position, const Vector& direction, const Vector& up);
+
+	void addKeyframe(double time, const Camera& camera);
+
+	const std::vector<CameraKeyframe>& getKeyframes() const;
+
+	double getStartTime() const;
+
+	double getEndTime() const;
+
+	//moves the camera to the position and orientation on the path at the given time,
+	//positions follow a Catmull-Rom spline through the keyframes and orientations are slerped
+	void apply(double time, Camera& camera) const;
+};
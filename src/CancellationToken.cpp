@@ -0,0 +1,38 @@
+#include <chrono>
+
+#include "CancellationToken.h"
+
+int64_t CancellationToken::now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool CancellationToken::isCancelled() const
+{
+	//polled from the innermost render loops, ordering with other data is not needed
+	return m_cancelled.load(std::memory_order_relaxed);
+}
+
+int CancellationToken::getMicrosecondsSinceCancel() const
+{
+	if (!isCancelled())
+	{
+		return 0;
+	}
+
+	return static_cast<int>(now() - m_cancelTime.load());
+}
+
+void CancellationToken::cancel()
+{
+	if (!m_cancelled.load())
+	{
+		m_cancelTime = now();
+		m_cancelled = true;
+	}
+}
+
+void CancellationToken::reset()
+{
+	m_cancelled = false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+class CancellationToken
+{
+private:
+
+	std::atomic<bool> m_cancelled = false;
+	std::atomic<int64_t> m_cancelTime = 0;
+
+	static int64_t now();
+
+public:
+
+	CancellationToken() = default;
+
+	CancellationToken(const CancellationToken& other) = delete;
+
+	CancellationToken(CancellationToken&& other) = delete;
+
+	CancellationToken& operator=(const CancellationToken& other) = delete;
+
+	CancellationToken& operator=(CancellationToken&& other) = delete;
+
+	~CancellationToken() = default;
+
+	bool isCancelled() const;
+
+	int getMicrosecondsSinceCancel() const;
+
+	void cancel();
+
+	void reset();
+};
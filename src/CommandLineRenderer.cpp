@@ -0,0 +1,453 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+#include "AnimationRenderer.h"
+#include "CameraPath.h"
+#include "CommandLineRenderer.h"
+#include "CompiledScene.h"
+#include "RayTracer.h"
+#include "Scene.h"
+#include "SettingsIO.h"
+
+#ifdef RAYTRACER_DISTRIBUTED
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "RenderCoordinator.h"
+#include "RenderDaemon.h"
+#include "RenderWorker.h"
+#endif
+
+void CommandLineRenderer::printUsage()
+{
+	std::cerr << "Usage: RayTracerCli <scene.csv> <output.bmp|output.ppm> [options]\n"
+		<< "       RayTracerCli <scene.csv> <frame_%04d.bmp> --path <path.csv> [options]\n"
+		<< "       RayTracerCli <scene.csv> <output.bmp|output.ppm> --listen <address> [options]\n"
+		<< "       RayTracerCli --worker <address> [--threads <count>]\n"
+		<< "       RayTracerCli --daemon <address> [--cache <scenes>]\n"
+		<< "       RayTracerCli <scene.csv> <output.bmp|output.ppm> --submit <address> [options]\n"
+		<< "       RayTracerCli --stop-daemon <address>\n"
+		<< "  --width <pixels>             image width, default 1280\n"
+		<< "  --height <pixels>            image height, default 720\n"
+		<< "  --threads <count>            render threads, default all cores\n"
+		<< "  --samples <count>            samples per pixel, more than 1 runs progressive refinement\n"
+		<< "  --noise <threshold>          stop refining below this noise level, default 0\n"
+		<< "  --recursion <depth>          overrides the scene's recursion depth\n"
+		<< "  --shadow-rays <count>        overrides the scene's soft shadow ray count\n"
+		<< "  --reflection-rays <count>    overrides the scene's blurry reflection ray count\n"
+		<< "  --refraction-rays <count>    overrides the scene's blurry refraction ray count\n"
+		<< "  --supersampling <0|1>        overrides the scene's adaptive supersampling switch\n"
+		<< "  --threshold <value>          overrides the scene's supersampling threshold\n"
+		<< "  --wavefront <0|1>            traces queues of rays per tile instead of every pixel recursively\n"
+		<< "  --ray-sorting <0|1>          sorts the wavefront's secondary rays by origin and direction, default 0\n"
+		<< "  --sampler <name>             random, stratified (default), halton or bluenoise points for soft shadows and blurry rays\n"
+		<< "  --adaptive-shadows <0|1>     spends the whole soft shadow ray budget only in the penumbra, default 1\n"
+		<< "  --min-throughput <value>     ends reflected and refracted paths carrying less than this, default 0.01\n"
+		<< "  --russian-roulette <0|1>     continues ending paths at random instead of dropping them, default 0\n"
+		<< "  --light-threshold <value>    skips lights that can add less than this to a point, default 0\n"
+		<< "  --light-samples <count>      samples this many lights by importance per point in scenes with more, default 0 for all\n"
+		<< "  --occluder-cache <0|1>       tests the last shape that blocked a light first, default 1\n"
+		<< "  --fresnel-selection <0|1>    follows only the reflection or the refraction of glass, picked by the Fresnel term, default 0\n"
+		<< "  --ray-budget <rays>          rays a pixel sample may spend, the ray counts shrink down its ray tree, default 0 for no limit\n"
+		<< "  --tile-ray-budget <rays>     rays a tile may spend, shared equally by its pixel samples, default 0 for no limit\n"
+		<< "  --benchmark <runs>           renders the image this many times and prints the timings instead of saving it\n"
+		<< "  --camera <p,p,p,d,d,d,u,u,u> overrides the scene's camera position, direction and up vector\n"
+		<< "  --path <path.csv>            renders every frame along the camera keyframes in the file\n"
+		<< "  --fps <rate>                 frames per second of the camera path, default 24\n"
+		<< "  --parallel-frames <count>    frames rendered at the same time, default one per thread\n"
+		<< "  --listen <address>           hands the tiles out to worker processes, unix:<path> or tcp:<host>:<port>\n"
+		<< "  --spawn-workers <count>      starts this many local worker processes for --listen\n"
+		<< "  --worker <address>           renders tiles for the coordinator at the address\n"
+		<< "  --daemon <address>           serves render jobs and keeps the parsed scenes cached\n"
+		<< "  --cache <scenes>             number of scenes the daemon keeps loaded, default 8\n"
+		<< "  --submit <address>           sends the render job to a running daemon\n"
+		<< "  --stop-daemon <address>      stops a running daemon\n";
+}
+
+bool CommandLineRenderer::parseArguments(int argc, char* argv[])
+{
+	int positional = 0;
+
+	try
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string argument = argv[i];
+
+			if (argument.rfind("--", 0) == 0)
+			{
+				if (i + 1 >= argc)
+				{
+					std::cerr << "Missing value for " << argument << "\n";
+					printUsage();
+					return false;
+				}
+
+				std::string value = argv[++i];
+
+				if (argument == "--width") m_job.m_width = std::stoi(value);
+				else if (argument == "--height") m_job.m_height = std::stoi(value);
+				else if (argument == "--threads") m_job.m_threadCount = std::stoi(value);
+				else if (argument == "--samples") m_job.m_samples = std::stoi(value);
+				else if (argument == "--noise") m_job.m_noiseThreshold = std::stod(value);
+				else if (argument == "--recursion") m_job.m_recursion = std::stoi(value);
+				else if (argument == "--shadow-rays") m_job.m_shadowDist = std::stoi(value);
+				else if (argument == "--reflection-rays") m_job.m_reflectionDist = std::stoi(value);
+				else if (argument == "--refraction-rays") m_job.m_refractionDist = std::stoi(value);
+				else if (argument == "--supersampling") m_job.m_adaptiveSuperSampling = std::stoi(value);
+				else if (argument == "--threshold") m_job.m_superSamplingThreshold = std::stod(value);
+				else if (argument == "--wavefront") m_job.m_wavefront = std::stoi(value);
+				else if (argument == "--ray-sorting") m_job.m_raySorting = std::stoi(value);
+				else if (argument == "--adaptive-shadows") m_job.m_adaptiveShadows = std::stoi(value);
+				else if (argument == "--min-throughput") m_job.m_minThroughput = std::stod(value);
+				else if (argument == "--russian-roulette") m_job.m_russianRoulette = std::stoi(value);
+				else if (argument == "--light-threshold") m_job.m_lightThreshold = std::stod(value);
+				else if (argument == "--light-samples") m_job.m_lightSampleCount = std::stoi(value);
+				else if (argument == "--occluder-cache") m_job.m_occluderCaching = std::stoi(value);
+				else if (argument == "--fresnel-selection") m_job.m_fresnelSelection = std::stoi(value);
+				else if (argument == "--ray-budget") m_job.m_rayBudget = std::stoi(value);
+				else if (argument == "--tile-ray-budget") m_job.m_tileRayBudget = std::stoi(value);
+				else if (argument == "--benchmark") m_benchmarkRuns = std::stoi(value);
+				else if (argument == "--sampler")
+				{
+					const std::vector<std::string> samplers = { "random", "stratified", "halton", "bluenoise" };
+					auto sampler = std::find(samplers.begin(), samplers.end(), value);
+
+					if (sampler == samplers.end())
+					{
+						std::cerr << "Unknown sampler " << value << "\n";
+						printUsage();
+						return false;
+					}
+
+					m_job.m_samplerType = static_cast<int>(sampler - samplers.begin());
+				}
+				else if (argument == "--path") m_pathFile = value;
+				else if (argument == "--fps") m_framesPerSecond = std::stod(value);
+				else if (argument == "--parallel-frames") m_parallelFrames = std::stoi(value);
+				else if (argument == "--listen") m_listenAddress = value;
+				else if (argument == "--spawn-workers") m_spawnWorkers = std::stoi(value);
+				else if (argument == "--worker") m_workerAddress = value;
+				else if (argument == "--daemon") m_daemonAddress = value;
+				else if (argument == "--cache") m_cacheCapacity = std::stoi(value);
+				else if (argument == "--submit") m_submitAddress = value;
+				else if (argument == "--stop-daemon") m_stopAddress = value;
+				else if (argument == "--camera")
+				{
+					if (!m_job.setCamera(value))
+					{
+						std::cerr << "The camera needs nine comma separated numbers\n";
+						printUsage();
+						return false;
+					}
+				}
+				else
+				{
+					std::cerr << "Unknown option " << argument << "\n";
+					printUsage();
+					return false;
+				}
+			}
+			else if (positional == 0)
+			{
+				m_job.m_sceneFile = argument;
+				positional++;
+			}
+			else if (positional == 1)
+			{
+				m_job.m_outputFile = argument;
+				positional++;
+			}
+			else
+			{
+				std::cerr << "Unexpected argument " << argument << "\n";
+				printUsage();
+				return false;
+			}
+		}
+	}
+	catch (const std::exception&)
+	{
+		std::cerr << "Invalid option value\n";
+		printUsage();
+		return false;
+	}
+
+	if (!m_workerAddress.empty() || !m_daemonAddress.empty() || !m_stopAddress.empty())
+	{
+		return true;
+	}
+
+	if (positional < 2 || m_job.m_width <= 0 || m_job.m_height <= 0 || m_job.m_samples < 1 || m_framesPerSecond <= 0.0)
+	{
+		printUsage();
+		return false;
+	}
+
+	return true;
+}
+
+int CommandLineRenderer::run()
+{
+	if (!m_workerAddress.empty())
+	{
+		return runWorker();
+	}
+
+	if (!m_daemonAddress.empty() || !m_submitAddress.empty() || !m_stopAddress.empty())
+	{
+		return m_daemonAddress.empty() ? submitJob() : runDaemon();
+	}
+
+	Scene scene;
+	RayTracer rayTracer(m_job.m_width, m_job.m_height, &scene, scene.getCamera());
+
+	if (!SettingsIO::loadSettings(m_job.m_sceneFile, scene, rayTracer))
+	{
+		std::cerr << "Unable to load scene " << m_job.m_sceneFile << "\n";
+		return 1;
+	}
+
+	rayTracer.init(&scene, scene.getCamera());
+	m_job.applySettings(rayTracer);
+	m_job.applyCamera(*scene.getCamera());
+
+	if (!m_pathFile.empty())
+	{
+		return renderAnimation(scene, rayTracer);
+	}
+
+	if (!m_listenAddress.empty())
+	{
+		return renderDistributed(scene, rayTracer);
+	}
+
+	if (m_benchmarkRuns > 0)
+	{
+		return runBenchmark(rayTracer);
+	}
+
+	CompiledScene compiledScene(scene);
+
+	return m_job.execute(rayTracer, compiledScene, std::cout) ? 0 : 1;
+}
+
+int CommandLineRenderer::renderAnimation(Scene& scene, const RayTracer& rayTracer)
+{
+	CameraPath path;
+	if (!path.load(m_pathFile))
+	{
+		std::cerr << "Unable to load camera path " << m_pathFile << "\n";
+		return 1;
+	}
+
+	AnimationRenderer animationRenderer(&scene, rayTracer);
+	animationRenderer.setRenderListener(this);
+	animationRenderer.setSize(m_job.m_width, m_job.m_height);
+	animationRenderer.setThreadCount(rayTracer.getThreadCount());
+	animationRenderer.setParallelFrames(m_parallelFrames);
+	animationRenderer.setSamples(m_job.m_samples);
+	animationRenderer.setNoiseThreshold(m_job.m_noiseThreshold);
+
+	int frameCount = AnimationRenderer::getFrameCount(path, m_framesPerSecond);
+
+	std::cout << "Rendering " << frameCount << " frames of " << m_job.m_width << "x" << m_job.m_height << " with " << rayTracer.getThreadCount() 
+		<< " threads, " << animationRenderer.getParallelFrames(frameCount) << " frames at a time\n";
+
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+	int failedFrames = animationRenderer.render(path, m_framesPerSecond, m_job.m_outputFile);
+
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	double seconds = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() / 1000000.0;
+
+	std::cout << "Rendered " << frameCount << " frames in " << seconds << " s, " << frameCount / seconds << " frames per second\n";
+
+	if (failedFrames > 0)
+	{
+		std::cerr << "Unable to write " << failedFrames << " frames, the extension has to be .bmp or .ppm\n";
+		return 1;
+	}
+
+	return 0;
+}
+
+int CommandLineRenderer::renderDistributed(Scene& scene, const RayTracer& rayTracer)
+{
+#ifdef RAYTRACER_DISTRIBUTED
+	//the local workers only connect, so they are started before the coordinator listens and retry until it does
+	std::vector<pid_t> children;
+	for (int i = 0; i < m_spawnWorkers; ++i)
+	{
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			RenderWorker worker;
+			worker.setThreadCount(std::max(1, rayTracer.getThreadCount() / m_spawnWorkers));
+			_exit(worker.run(m_listenAddress) ? 0 : 1);
+		}
+		else if (pid > 0)
+		{
+			children.push_back(pid);
+		}
+	}
+
+	RenderCoordinator coordinator;
+	if (!coordinator.listen(m_listenAddress))
+	{
+		std::cerr << "Unable to listen on " << m_listenAddress << "\n";
+		for (pid_t pid : children)
+		{
+			kill(pid, SIGTERM);
+			waitpid(pid, nullptr, 0);
+		}
+		return 1;
+	}
+
+	std::cout << "Waiting for workers on " << m_listenAddress << "\n";
+
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+	Image image;
+	bool rendered = coordinator.render(scene, rayTracer, m_job.m_width, m_job.m_height, image);
+
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	for (pid_t pid : children)
+	{
+		waitpid(pid, nullptr, 0);
+	}
+
+	if (!rendered)
+	{
+		std::cerr << "No workers connected to " << m_listenAddress << "\n";
+		return 1;
+	}
+
+	std::cout << "Rendered " << m_job.m_width << "x" << m_job.m_height << " on workers in " 
+		<< std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() / 1000000.0 << " s, " 
+		<< coordinator.getLostWorkers() << " workers lost, " << coordinator.getReissuedTiles() << " tiles reissued\n";
+
+	if (!image.save(m_job.m_outputFile))
+	{
+		std::cerr << "Unable to write " << m_job.m_outputFile << ", the extension has to be .bmp or .ppm\n";
+		return 1;
+	}
+
+	return 0;
+#else
+	std::cerr << "Distributed rendering is only available on POSIX systems\n";
+	return 1;
+#endif
+}
+
+int CommandLineRenderer::runBenchmark(RayTracer& rayTracer)
+{
+	//the first render only warms up the caches and is not counted
+	rayTracer.render();
+
+	std::vector<int> times;
+
+	for (int run = 0; run < m_benchmarkRuns; ++run)
+	{
+		times.push_back(rayTracer.render());
+
+		std::cout << "Run " << run + 1 << ": " << times.back() / 1000000.0 << " s\n";
+	}
+
+	std::sort(times.begin(), times.end());
+
+	int64_t sum = 0;
+	for (int time : times)
+	{
+		sum += time;
+	}
+
+	std::cout << "Rendered " << m_job.m_width << "x" << m_job.m_height << " " << m_benchmarkRuns << " times with " << rayTracer.getThreadCount() 
+		<< " threads, best " << times.front() / 1000000.0 << " s, median " << times[times.size() / 2] / 1000000.0 
+		<< " s, mean " << sum / static_cast<double>(times.size()) / 1000000.0 << " s\n";
+
+	RenderJob::logStatistics(rayTracer, std::cout);
+
+	return 0;
+}
+
+int CommandLineRenderer::runWorker()
+{
+#ifdef RAYTRACER_DISTRIBUTED
+	RenderWorker worker;
+	if (m_job.m_threadCount > 0)
+	{
+		worker.setThreadCount(m_job.m_threadCount);
+	}
+
+	if (!worker.run(m_workerAddress))
+	{
+		std::cerr << "Lost the connection to " << m_workerAddress << "\n";
+		return 1;
+	}
+
+	return 0;
+#else
+	std::cerr << "Distributed rendering is only available on POSIX systems\n";
+	return 1;
+#endif
+}
+
+int CommandLineRenderer::runDaemon()
+{
+#ifdef RAYTRACER_DISTRIBUTED
+	RenderDaemon daemon;
+	daemon.setCacheCapacity(std::max(1, m_cacheCapacity));
+
+	if (!daemon.listen(m_daemonAddress))
+	{
+		std::cerr << "Unable to listen on " << m_daemonAddress << "\n";
+		return 1;
+	}
+
+	std::cout << "Serving render jobs on " << m_daemonAddress << "\n";
+
+	daemon.run();
+
+	return 0;
+#else
+	std::cerr << "The render daemon is only available on POSIX systems\n";
+	return 1;
+#endif
+}
+
+int CommandLineRenderer::submitJob()
+{
+#ifdef RAYTRACER_DISTRIBUTED
+	if (!m_stopAddress.empty())
+	{
+		return RenderDaemon::shutdown(m_stopAddress) ? 0 : 1;
+	}
+
+	//the daemon can run in another directory
+	RenderJob job = m_job;
+	job.m_sceneFile = std::filesystem::absolute(job.m_sceneFile).string();
+	job.m_outputFile = std::filesystem::absolute(job.m_outputFile).string();
+
+	std::string log;
+	bool succeeded = RenderDaemon::submit(m_submitAddress, job, log);
+
+	(succeeded ? std::cout : std::cerr) << log;
+
+	return succeeded ? 0 : 1;
+#else
+	std::cerr << "The render daemon is only available on POSIX systems\n";
+	return 1;
+#endif
+}
+
+void CommandLineRenderer::onFrameFinished(int frame, int microseconds, bool saved)
+{
+	std::lock_guard<std::mutex> lock(m_outputMutex);
+
+	std::cout << "Frame " << frame << (saved ? " finished" : " failed") << " in " << microseconds / 1000000.0 << " s\n";
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+
+#include "RenderJob.h"
+#include "RenderListener.h"
+
+class Scene;
+
+class CommandLineRenderer : public RenderListener
+{
+private:
+
+	RenderJob m_job;
+	std::string m_pathFile;
+	double m_framesPerSecond = 24.0;
+	int m_parallelFrames = 0;
+	std::string m_listenAddress;
+	std::string m_workerAddress;
+	int m_spawnWorkers = 0;
+	std::string m_daemonAddress;
+	std::string m_submitAddress;
+	std::string m_stopAddress;
+	int m_cacheCapacity = 8;
+	int m_benchmarkRuns = 0;
+	std::mutex m_outputMutex;
+
+	static void printUsage();
+
+	int renderAnimation(Scene& scene, const RayTracer& rayTracer);
+
+	int renderDistributed(Scene& scene, const RayTracer& rayTracer);
+
+	int runBenchmark(RayTracer& rayTracer);
+
+	int runWorker();
+
+	int runDaemon();
+
+	int submitJob();
+
+public:
+
+	CommandLineRenderer() = default;
+
+	CommandLineRenderer(const CommandLineRenderer& other) = default;
+
+	CommandLineRenderer(CommandLineRenderer&& other) = default;
+
+	CommandLineRenderer& operator=(const CommandLineRenderer& other) = default;
+
+	CommandLineRenderer& operator=(CommandLineRenderer&& other) = default;
+
+	~CommandLineRenderer() override = default;
+
+	bool parseArguments(int argc, char* argv[]);
+
+	int run();
+
+	void onFrameFinished(int frame, int microseconds, bool saved) override;
+};
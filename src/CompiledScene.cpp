@@ -0,0 +1,63 @@
+#include <algorithm>
+
+#include "CompiledScene.h"
+
+std::atomic<uint64_t> CompiledScene::m_nextId{ 1 };
+
+CompiledScene::CompiledScene(Scene& scene)
+	: m_id(m_nextId++)
+{
+	for (const ComponentShape* shape : scene.getShapes())
+	{
+		if (shape->isEnabled())
+		{
+			m_shapes.push_back(shape);
+		}
+	}
+
+	for (const Light* light : scene.getLights())
+	{
+		if (!light->isEnabled())
+		{
+			continue;
+		}
+
+		//only area lights get several shadow rays, the type is looked up here instead of on every hit
+		const SphereLight* sphereLight = dynamic_cast<const SphereLight*>(light);
+		LightType type = sphereLight != nullptr ? LightType::SPHERE : LightType::POINT;
+		double radius = sphereLight != nullptr ? sphereLight->getRadius() : 0.0;
+
+		m_lights.push_back({ light, type, light->getColor(), radius });
+	}
+
+	std::vector<LightTree::Emitter> emitters;
+	emitters.reserve(m_lights.size());
+
+	for (const CompiledLight& light : m_lights)
+	{
+		const Color& color = light.m_color;
+		emitters.push_back({ light.m_light->getPosition(), light.m_radius, std::max(color.m_red, std::max(color.m_green, color.m_blue)) });
+	}
+
+	m_lightTree = LightTree(emitters);
+}
+
+const std::vector<const ComponentShape*>& CompiledScene::getShapes() const
+{
+	return m_shapes;
+}
+
+const std::vector<CompiledScene::CompiledLight>& CompiledScene::getLights() const
+{
+	return m_lights;
+}
+
+const LightTree& CompiledScene::getLightTree() const
+{
+	return m_lightTree;
+}
+
+uint64_t CompiledScene::getId() const
+{
+	return m_id;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "Color.h"
+#include "ComponentShape.h"
+#include "Light.h"
+#include "LightTree.h"
+#include "Scene.h"
+
+//flat, read only view of the enabled parts of a scene, built once when a render starts so the render threads 
+//neither allocate nor look up light types per hit, the scene has to outlive it and must not change while it is used
+class CompiledScene
+{
+public:
+
+	enum class LightType
+	{
+		POINT,
+		SPHERE
+	};
+
+	struct CompiledLight
+	{
+		const Light* m_light;
+		LightType m_type;
+		Color m_color;
+		double m_radius;
+	};
+
+private:
+
+	std::vector<const ComponentShape*> m_shapes;
+	std::vector<CompiledLight> m_lights;
+	LightTree m_lightTree;
+	uint64_t m_id = 0;
+
+	static std::atomic<uint64_t> m_nextId;
+
+public:
+
+	explicit CompiledScene(Scene& scene);
+
+	CompiledScene(const CompiledScene& other) = default;
+
+	CompiledScene(CompiledScene&& other) = default;
+
+	CompiledScene& operator=(const CompiledScene& other) = default;
+
+	CompiledScene& operator=(CompiledScene&& other) = default;
+
+	~CompiledScene() = default;
+
+	const std::vector<const ComponentShape*>& getShapes() const;
+
+	const std::vector<CompiledLight>& getLights() const;
+
+	//indices of the tree refer to getLights()
+	const LightTree& getLightTree() const;
+
+	//different for every compiled scene, caches that keep pointers into a scene use it to notice when they see a new one
+	uint64_t getId() const;
+};
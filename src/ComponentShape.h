@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "EntityDescriptionInterface.h"
 #include "Intersection.h"
 #include "Material.h"
@@ -7,6 +7,7 @@
 #include "Model.h"
 #include "Utility.h"
 
+#include <algorithm>
 #include <sstream>
 #include <stack>
 
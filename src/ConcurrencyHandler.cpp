@@ -1,17 +1,28 @@
 #include "ConcurrencyHandler.h"
 
-ConcurrencyHandler::ConcurrencyHandler(QObject* parent, RayTracer* rayTracer)
+ConcurrencyHandler::ConcurrencyHandler(QObject* parent, RayTracer* rayTracer, Scene* scene)
 	: QObject(parent)
 	, m_rayTracer(rayTracer)
+	, m_scene(scene)
 {
-
+	if (m_rayTracer != nullptr)
+	{
+		m_rayTracer->setRenderListener(this);
+	}
 }
 
-void ConcurrencyHandler::init(RayTracer* rayTracer)
+void ConcurrencyHandler::init(RayTracer* rayTracer, Scene* scene)
 {
 	onCancelRendering();
 
 	m_rayTracer = rayTracer;
+	m_scene = scene;
+	m_sceneDirty = true;
+
+	if (m_rayTracer != nullptr)
+	{
+		m_rayTracer->setRenderListener(this);
+	}
 }
 
 bool ConcurrencyHandler::isRendering() const
@@ -19,48 +30,134 @@ bool ConcurrencyHandler::isRendering() const
 	return m_renderFuture.isRunning();
 }
 
-void ConcurrencyHandler::onRender()
+int ConcurrencyHandler::getCancelCount() const
 {
-	if (m_connected == false)
+	return m_cancelCount;
+}
+
+int ConcurrencyHandler::getLastCancelLatency() const
+{
+	return m_lastCancelLatency;
+}
+
+int ConcurrencyHandler::getMaxCancelLatency() const
+{
+	return m_maxCancelLatency;
+}
+
+int ConcurrencyHandler::getAverageCancelLatency() const
+{
+	if (m_cancelCount == 0)
 	{
-		connect();
+		return 0;
 	}
 
-	onCancelRendering();
+	return static_cast<int>(m_totalCancelLatency / m_cancelCount);
+}
 
-	m_rayTracer->setPreviewMode(true);
+FrameTimeController& ConcurrencyHandler::getFrameTimeController()
+{
+	return m_frameTimeController;
+}
+
+std::vector<Tile> ConcurrencyHandler::takeDirtyTiles()
+{
+	std::lock_guard<std::mutex> lock(m_dirtyTilesMutex);
+
+	std::vector<Tile> dirtyTiles;
+	dirtyTiles.swap(m_dirtyTiles);
 
-	render();
+	return dirtyTiles;
 }
 
-void ConcurrencyHandler::onRenderPreview()
+void ConcurrencyHandler::onTileFinished(const Tile& tile)
 {
-	if (m_connected == false)
-	{
-		connect();
-	}
+	std::lock_guard<std::mutex> lock(m_dirtyTilesMutex);
 
-	onCancelRendering();
+	m_dirtyTiles.push_back(tile);
+}
 
-	m_rayTracer->setPreviewMode(true);
+void ConcurrencyHandler::onRefinementUpdated(int samples, double noise)
+{
+	emit refinementUpdated(samples, noise);
+}
+
+void ConcurrencyHandler::onRender()
+{
+	request(RenderRequest::PREVIEW_AND_FINAL);
+}
 
-	renderPreview();
+void ConcurrencyHandler::onRenderPreview()
+{
+	request(RenderRequest::PREVIEW);
 }
 
 void ConcurrencyHandler::onCancelRendering()
 {
+	m_pendingRequest = RenderRequest::NONE;
+
 	if (m_renderFuture.isRunning())
 	{
-		m_rayTracer->cancelRendering();
+		cancel();
+
+		//callers of this slot modify the scene or the image right afterwards, 
+		//so this is the one place that has to wait for the render thread
 		m_renderFuture.waitForFinished();
+
+		recordCancellation();
 	}
 }
 
+void ConcurrencyHandler::onSceneChanged()
+{
+	m_sceneDirty = true;
+}
+
 void ConcurrencyHandler::onRenderFinished()
 {
+	if (m_cancelled == true)
+	{
+		recordCancellation();
+
+		RenderRequest pendingRequest = m_pendingRequest;
+		m_pendingRequest = RenderRequest::NONE;
+
+		if (pendingRequest != RenderRequest::NONE)
+		{
+			request(pendingRequest);
+		}
+
+		return;
+	}
+
+	if (m_refining == true)
+	{
+		m_refining = false;
+
+		emit refinementFinished(m_rayTracer->getAccumulatedSamples(), m_rayTracer->getRefinementNoise());
+
+		return;
+	}
+
 	if (m_rayTracer->getPreviewMode() == true)
 	{
-		emit renderPreviewFinished();
+		int subSamplingSize = m_rayTracer->getPreviewSubSamplingSize();
+
+		//the next preview frame is sized from how long this one took
+		m_frameTimeController.addFrame(m_renderFuture.result());
+
+		if (m_frameTimeController.isEnabled())
+		{
+			m_rayTracer->setPreviewSubSamplingSize(m_frameTimeController.getSubSamplingSize());
+			m_rayTracer->setPreviewShadows(m_frameTimeController.getShadows());
+		}
+		else
+		{
+			m_rayTracer->setPreviewSubSamplingSize(0);
+			m_rayTracer->setPreviewShadows(true);
+		}
+
+		emit renderPreviewFinished(m_renderFuture.result(), subSamplingSize);
 	}
 	else
 	{
@@ -73,6 +170,10 @@ void ConcurrencyHandler::onRenderFinished()
 
 		render();
 	}
+	else if (m_previewAndFinal == true && m_rayTracer->getProgressiveRefinement() == true)
+	{
+		refine();
+	}
 }
 
 void ConcurrencyHandler::connect()
@@ -82,9 +183,94 @@ void ConcurrencyHandler::connect()
 	m_connected = true;
 }
 
+void ConcurrencyHandler::request(RenderRequest renderRequest)
+{
+	if (m_connected == false)
+	{
+		connect();
+	}
+
+	//the render thread only polls the cancellation token, so instead of waiting for it here 
+	//the request is remembered and started from onRenderFinished
+	if (m_renderFuture.isRunning())
+	{
+		cancel();
+
+		m_pendingRequest = renderRequest;
+
+		return;
+	}
+
+	m_rayTracer->setPreviewMode(true);
+
+	if (renderRequest == RenderRequest::PREVIEW_AND_FINAL)
+	{
+		render();
+	}
+	else
+	{
+		renderPreview();
+	}
+}
+
+void ConcurrencyHandler::cancel()
+{
+	if (m_cancelled == false)
+	{
+		m_cancelled = true;
+		m_cancellationRecorded = false;
+
+		m_rayTracer->cancelRendering();
+	}
+}
+
+void ConcurrencyHandler::recordCancellation()
+{
+	if (m_cancellationRecorded == true)
+	{
+		return;
+	}
+	m_cancellationRecorded = true;
+
+	int latency = m_rayTracer->getCancelLatency();
+
+	m_cancelCount++;
+	m_lastCancelLatency = latency;
+	m_maxCancelLatency = std::max(m_maxCancelLatency, latency);
+	m_totalCancelLatency += latency;
+
+	emit renderCancelled(latency);
+}
+
+void ConcurrencyHandler::takeSceneSnapshot()
+{
+	//the render thread only reads the snapshot, so the scene can be edited and the camera moved while it runs, 
+	//copying the whole scene is only needed after an edit, camera movement just replaces the camera
+	if (m_sceneDirty == true)
+	{
+		m_sceneSnapshot = *m_scene;
+		m_sceneDirty = false;
+
+		//colors reprojected from the previous frame belong to the old scene
+		m_rayTracer->invalidateReprojection();
+	}
+	else
+	{
+		m_sceneSnapshot.setCamera(*m_scene->getCamera());
+	}
+
+	m_rayTracer->init(&m_sceneSnapshot, m_sceneSnapshot.getCamera());
+}
+
 void ConcurrencyHandler::render()
 {
 	m_previewAndFinal = true;
+	m_refining = false;
+	m_cancelled = false;
+
+	takeSceneSnapshot();
+
+	m_rayTracer->resetCancellation();
 
 	m_renderFuture = QtConcurrent::run([this]()
 	{
@@ -97,6 +283,12 @@ void ConcurrencyHandler::render()
 void ConcurrencyHandler::renderPreview()
 {
 	m_previewAndFinal = false;
+	m_refining = false;
+	m_cancelled = false;
+
+	takeSceneSnapshot();
+
+	m_rayTracer->resetCancellation();
 
 	m_renderFuture = QtConcurrent::run([this]()
 	{
@@ -105,3 +297,19 @@ void ConcurrencyHandler::renderPreview()
 
 	m_renderFutureWatcher.setFuture(m_renderFuture);
 }
+
+void ConcurrencyHandler::refine()
+{
+	m_previewAndFinal = false;
+	m_refining = true;
+	m_cancelled = false;
+
+	m_rayTracer->resetCancellation();
+
+	m_renderFuture = QtConcurrent::run([this]()
+	{
+		return m_rayTracer->refine();
+	});
+
+	m_renderFutureWatcher.setFuture(m_renderFuture);
+}
@@ -3,15 +3,21 @@
 #include <QObject>
 #include <QtConcurrent>
 
+#include <mutex>
+#include <vector>
+
+#include "FrameTimeController.h"
 #include "RayTracer.h"
+#include "RenderListener.h"
+#include "Scene.h"
 
-class ConcurrencyHandler : public QObject
+class ConcurrencyHandler : public QObject, public RenderListener
 {
 	Q_OBJECT
 
 public:
 
-	explicit ConcurrencyHandler(QObject* parent = nullptr, RayTracer* rayTracer = nullptr);
+	explicit ConcurrencyHandler(QObject* parent = nullptr, RayTracer* rayTracer = nullptr, Scene* scene = nullptr);
 
 	ConcurrencyHandler(const ConcurrencyHandler& other) = default;
 
@@ -23,10 +29,29 @@ public:
 
 	~ConcurrencyHandler() override = default;
 
-	void init(RayTracer* rayTracer);
+	void init(RayTracer* rayTracer, Scene* scene);
 
 	bool isRendering() const;
 
+	int getCancelCount() const;
+
+	int getLastCancelLatency() const;
+
+	int getMaxCancelLatency() const;
+
+	int getAverageCancelLatency() const;
+
+	FrameTimeController& getFrameTimeController();
+
+	//returns the tiles finished since the last call and forgets them
+	std::vector<Tile> takeDirtyTiles();
+
+	//finished tiles are only collected here, the display picks them up at its own rate
+	void onTileFinished(const Tile& tile) override;
+
+	//forwarded from the render thread as a queued signal to the GUI thread
+	void onRefinementUpdated(int samples, double noise) override;
+
 public slots:
 
 	void onRender();
@@ -35,6 +60,8 @@ public slots:
 
 	void onCancelRendering();
 
+	void onSceneChanged();
+
 private slots:
 
 	void onRenderFinished();
@@ -43,22 +70,59 @@ signals:
 
 	void renderFinished(int microseconds);
 
-	void renderPreviewFinished();
+	void renderPreviewFinished(int microseconds, int subSamplingSize);
+
+	void refinementFinished(int samples, double noise);
+
+	void renderCancelled(int microseconds);
+
+	void refinementUpdated(int samples, double noise);
 
 private:
 
+	enum class RenderRequest
+	{
+		NONE,
+		PREVIEW,
+		PREVIEW_AND_FINAL
+	};
+
 	RayTracer* m_rayTracer = nullptr;
+	Scene* m_scene = nullptr;
+	Scene m_sceneSnapshot;
+	FrameTimeController m_frameTimeController;
+	bool m_sceneDirty = true;
+	std::vector<Tile> m_dirtyTiles;
+	std::mutex m_dirtyTilesMutex;
 
 	QFuture<int> m_renderFuture;
 	QFutureWatcher<int> m_renderFutureWatcher;
 
 	void connect();
 
+	void request(RenderRequest renderRequest);
+
+	void cancel();
+
+	void recordCancellation();
+
+	void takeSceneSnapshot();
+
 	void render();
 
 	void renderPreview();
 
+	void refine();
+
 	bool m_connected = false;
 	bool m_previewAndFinal = false;
+	bool m_refining = false;
+	bool m_cancelled = false;
+	bool m_cancellationRecorded = false;
+	RenderRequest m_pendingRequest = RenderRequest::NONE;
+
+	int m_cancelCount = 0;
+	int m_lastCancelLatency = 0;
+	int m_maxCancelLatency = 0;
+	int64_t m_totalCancelLatency = 0;
 };
-
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cmath>
+
+#include "FrameTimeController.h"
+
+bool FrameTimeController::isEnabled() const
+{
+	return m_enabled;
+}
+
+int FrameTimeController::getTargetFrameTime() const
+{
+	return m_targetFrameTime;
+}
+
+int FrameTimeController::getLastFrameTime() const
+{
+	return m_lastFrameTime;
+}
+
+int FrameTimeController::getSubSamplingSize() const
+{
+	return static_cast<int>(std::lround(m_subSamplingSize));
+}
+
+bool FrameTimeController::getShadows() const
+{
+	return m_shadows;
+}
+
+void FrameTimeController::setEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+void FrameTimeController::setTargetFrameTime(int microseconds)
+{
+	m_targetFrameTime = std::max(1, microseconds);
+}
+
+void FrameTimeController::reset(int subSamplingSize)
+{
+	m_subSamplingSize = std::min(std::max(subSamplingSize, MIN_SUB_SAMPLING_SIZE), MAX_SUB_SAMPLING_SIZE);
+	m_shadows = true;
+}
+
+void FrameTimeController::addFrame(int microseconds)
+{
+	m_lastFrameTime = microseconds;
+
+	if (m_enabled == false || microseconds <= 0)
+	{
+		return;
+	}
+
+	double ratio = static_cast<double>(microseconds) / m_targetFrameTime;
+
+	//small deviations are noise, reacting to them would make the preview flicker between resolutions
+	if (ratio > 0.85 && ratio < 1.15)
+	{
+		return;
+	}
+
+	//the number of rays falls with the square of the block size, 
+	//so the block size follows the square root of the time ratio, limited to halving or doubling per frame
+	ratio = std::min(std::max(ratio, 0.25), 4.0);
+	m_subSamplingSize = std::min(std::max(m_subSamplingSize * sqrt(ratio), static_cast<double>(MIN_SUB_SAMPLING_SIZE)), static_cast<double>(MAX_SUB_SAMPLING_SIZE));
+
+	//shadow rays are given up only when even the coarsest blocks are too slow
+	if (m_shadows == true && microseconds > m_targetFrameTime && getSubSamplingSize() >= MAX_SUB_SAMPLING_SIZE)
+	{
+		m_shadows = false;
+	}
+	else if (m_shadows == false && microseconds < m_targetFrameTime / 2)
+	{
+		m_shadows = true;
+	}
+}
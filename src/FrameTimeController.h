@@ -0,0 +1,47 @@
+#pragma once
+
+class FrameTimeController
+{
+private:
+
+	bool m_enabled = true;
+	int m_targetFrameTime = 33000;
+	int m_lastFrameTime = 0;
+	double m_subSamplingSize = 20.0;
+	bool m_shadows = true;
+
+	static constexpr int MIN_SUB_SAMPLING_SIZE = 1;
+	static constexpr int MAX_SUB_SAMPLING_SIZE = 64;
+
+public:
+
+	FrameTimeController() = default;
+
+	FrameTimeController(const FrameTimeController& other) = default;
+
+	FrameTimeController(FrameTimeController&& other) = default;
+
+	FrameTimeController& operator=(const FrameTimeController& other) = default;
+
+	FrameTimeController& operator=(FrameTimeController&& other) = default;
+
+	~FrameTimeController() = default;
+
+	bool isEnabled() const;
+
+	int getTargetFrameTime() const;
+
+	int getLastFrameTime() const;
+
+	int getSubSamplingSize() const;
+
+	bool getShadows() const;
+
+	void setEnabled(bool enabled);
+
+	void setTargetFrameTime(int microseconds);
+
+	void reset(int subSamplingSize);
+
+	void addFrame(int microseconds);
+};
@@ -1,4 +1,9 @@
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+
 #include "Image.h"
 
 double Image::saturate(double x) const
@@ -58,3 +63,110 @@ void Image::resize(int width, int height)
 	m_data = std::vector<std::vector<Color>>(height, std::vector<Color>(width, Color()));
 	m_pixmap = std::vector<unsigned char>(4 * width * height, 0);
 }
+
+void Image::copyRegion(const Image& source, int x, int y, int width, int height)
+{
+	if (source.m_width != m_width || source.m_height != m_height)
+	{
+		return;
+	}
+
+	int x2 = std::min(x + width, m_width);
+	int y2 = std::min(y + height, m_height);
+	x = std::max(x, 0);
+	y = std::max(y, 0);
+
+	if (x >= x2 || y >= y2)
+	{
+		return;
+	}
+
+	for (int yy = y; yy < y2; ++yy)
+	{
+		std::copy(source.m_data[yy].begin() + x, source.m_data[yy].begin() + x2, m_data[yy].begin() + x);
+
+		int i = (m_width * yy + x) * 4;
+		std::copy(source.m_pixmap.begin() + i, source.m_pixmap.begin() + i + (x2 - x) * 4, m_pixmap.begin() + i);
+	}
+}
+
+bool Image::save(const std::string& filename) const
+{
+	size_t dot = filename.find_last_of('.');
+	if (dot == std::string::npos || m_pixmap.empty())
+	{
+		return false;
+	}
+
+	std::string extension = filename.substr(dot + 1);
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+	if (extension != "bmp" && extension != "ppm")
+	{
+		return false;
+	}
+
+	std::ofstream ofs(filename, std::ios::binary);
+	if (!ofs.is_open())
+	{
+		return false;
+	}
+
+	if (extension == "ppm")
+	{
+		ofs << "P6\n" << m_width << " " << m_height << "\n255\n";
+
+		for (int i = 0; i < m_width * m_height; ++i)
+		{
+			//the pixmap is stored as BGRA
+			ofs.put(static_cast<char>(m_pixmap[i * 4 + 2]));
+			ofs.put(static_cast<char>(m_pixmap[i * 4 + 1]));
+			ofs.put(static_cast<char>(m_pixmap[i * 4 + 0]));
+		}
+	}
+	else
+	{
+		int rowSize = (m_width * 3 + 3) & ~3;
+		uint32_t imageSize = rowSize * m_height;
+
+		auto write16 = [&ofs](uint16_t value) { ofs.put(static_cast<char>(value & 0xff)); ofs.put(static_cast<char>(value >> 8)); };
+		auto write32 = [&ofs](uint32_t value) { for (int i = 0; i < 4; ++i) ofs.put(static_cast<char>((value >> (8 * i)) & 0xff)); };
+
+		//file header
+		ofs.put('B');
+		ofs.put('M');
+		write32(54 + imageSize);
+		write32(0);
+		write32(54);
+
+		//info header
+		write32(40);
+		write32(m_width);
+		write32(m_height);
+		write16(1);
+		write16(24);
+		write32(0);
+		write32(imageSize);
+		write32(2835);
+		write32(2835);
+		write32(0);
+		write32(0);
+
+		//rows are stored bottom up
+		std::vector<char> row(rowSize, 0);
+		for (int y = m_height - 1; y >= 0; --y)
+		{
+			for (int x = 0; x < m_width; ++x)
+			{
+				int i = (y * m_width + x) * 4;
+				row[x * 3 + 0] = static_cast<char>(m_pixmap[i + 0]);
+				row[x * 3 + 1] = static_cast<char>(m_pixmap[i + 1]);
+				row[x * 3 + 2] = static_cast<char>(m_pixmap[i + 2]);
+			}
+
+			ofs.write(row.data(), rowSize);
+		}
+	}
+
+	return ofs.good();
+}
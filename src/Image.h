@@ -2,6 +2,7 @@
 
 #include "Color.h"
 
+#include <string>
 #include <vector>
 
 class Image
@@ -42,6 +43,11 @@ public:
     const Color& getPixel(int x, int y) const;
 
     void resize(int width, int height);
+
+    void copyRegion(const Image& source, int x, int y, int width, int height);
+
+    //writes a .bmp or .ppm file depending on the extension
+    bool save(const std::string& filename) const;
 };
 
 
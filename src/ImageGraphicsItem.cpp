@@ -0,0 +1,56 @@
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+#include <cstring>
+
+#include "ImageGraphicsItem.h"
+
+ImageGraphicsItem::ImageGraphicsItem(QGraphicsItem* parent)
+	: QGraphicsItem(parent)
+{
+	//needed for the exposed rectangle in paint
+	setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+QRectF ImageGraphicsItem::boundingRect() const
+{
+	return QRectF(0, 0, m_image.width(), m_image.height());
+}
+
+void ImageGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+	QRectF exposedRect = option->exposedRect.intersected(boundingRect());
+
+	painter->drawImage(exposedRect, m_image, exposedRect);
+}
+
+const QImage& ImageGraphicsItem::getImage() const
+{
+	return m_image;
+}
+
+void ImageGraphicsItem::setImage(const QImage& image)
+{
+	prepareGeometryChange();
+
+	m_image = image;
+
+	update();
+}
+
+void ImageGraphicsItem::updateRegion(const unsigned char* pixmap, int width, int height, const QRect& rect)
+{
+	if (pixmap == nullptr || width != m_image.width() || height != m_image.height())
+	{
+		return;
+	}
+
+	QRect region = rect.intersected(QRect(0, 0, width, height));
+
+	for (int y = region.top(); y <= region.bottom(); ++y)
+	{
+		std::memcpy(m_image.scanLine(y) + region.left() * 4, pixmap + (y * width + region.left()) * 4, region.width() * 4);
+	}
+
+	update(region);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QGraphicsItem>
+#include <QImage>
+#include <QRect>
+
+//shows an image and repaints only the regions that changed, unlike QGraphicsPixmapItem which needs a new pixmap for every change
+class ImageGraphicsItem : public QGraphicsItem
+{
+public:
+
+	explicit ImageGraphicsItem(QGraphicsItem* parent = nullptr);
+
+	ImageGraphicsItem(const ImageGraphicsItem& other) = delete;
+
+	ImageGraphicsItem(ImageGraphicsItem&& other) = delete;
+
+	ImageGraphicsItem& operator=(const ImageGraphicsItem& other) = delete;
+
+	ImageGraphicsItem& operator=(ImageGraphicsItem&& other) = delete;
+
+	~ImageGraphicsItem() override = default;
+
+	QRectF boundingRect() const override;
+
+	void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+	const QImage& getImage() const;
+
+	void setImage(const QImage& image);
+
+	//copies a rectangle of a 32 bit pixmap with the same size as the image and schedules a repaint of just that rectangle
+	void updateRegion(const unsigned char* pixmap, int width, int height, const QRect& rect);
+
+private:
+
+	QImage m_image;
+};
@@ -1,16 +1,17 @@
 
 #include <chrono>
+#include <thread>
 #include <sstream>
 
 #include "Light.h"
-#include "Quaternion.h"
 #include "Constants.h"
+#include "Sampler.h"
 #include "Utility.h"
 
 std::string PointLight::DESCRIPTION_LABEL = "PointLight";
 std::string SphereLight::DESCRIPTION_LABEL = "SphereLight";
 
-std::default_random_engine SphereLight::m_randomEngine(std::chrono::system_clock::now().time_since_epoch().count());
+thread_local std::default_random_engine SphereLight::m_randomEngine(std::chrono::system_clock::now().time_since_epoch().count() ^ std::hash<std::thread::id>()(std::this_thread::get_id()));
 
 Light::Light(const Vector& position, const Color& color, const std::string& name)
     : NamedEntity(name)
@@ -62,6 +63,16 @@ Ray PointLight::getShadowRay(const Vector& point, bool distribution) const
     return Ray(point, getPosition() - point);
 }
 
+Ray PointLight::getShadowRay(const Vector& point, double u, double v) const
+{
+    return Ray(point, getPosition() - point);
+}
+
+Ray PointLight::getShadowRay(const Vector& point, const OrthonormalBasis& basis, double u, double v) const
+{
+    return Ray(point, getPosition() - point);
+}
+
 std::unique_ptr<Light> PointLight::clone() const
 {
     return std::make_unique<PointLight>(*this);
@@ -122,19 +133,11 @@ Ray SphereLight::getShadowRay(const Vector& point, bool distribution) const
 {
     if (distribution)
     {
-		std::uniform_int_distribution<int> distribution1(1, 100);
-        double rad = distribution1(m_randomEngine) * 0.01 * m_radius;
-        Vector perp = normalize(perpendicular(getPosition() - point));
-        double ratio = (2 * Constants::PI * rad) / (2 * Constants::PI * m_radius);
-		std::uniform_int_distribution<int> distribution2(0, static_cast<int>(360 * ratio));
-        int pt = distribution2(m_randomEngine);
-        double angle = pt * (360 / ratio);
-        Matrix mat = Quaternion::getMatrix(angle, Vector(getPosition() - point));
-        perp = normalize(mat * perp);
-
-        Vector lightPoint = getPosition() + (rad * perp);
-
-        return Ray(point, lightPoint - point);
+        std::uniform_real_distribution<double> distribution1(0.0, 1.0);
+        double u = distribution1(m_randomEngine);
+        double v = distribution1(m_randomEngine);
+
+        return getShadowRay(point, u, v);
     }
     else
     {
@@ -142,6 +145,23 @@ Ray SphereLight::getShadowRay(const Vector& point, bool distribution) const
     }
 }
 
+Ray SphereLight::getShadowRay(const Vector& point, double u, double v) const
+{
+    return getShadowRay(point, OrthonormalBasis(getPosition() - point), u, v);
+}
+
+Ray SphereLight::getShadowRay(const Vector& point, const OrthonormalBasis& basis, double u, double v) const
+{
+    //the disk of the sphere facing the point, sampled uniformly by area
+    double x;
+    double y;
+    Sampler::toDisk(u, v, x, y);
+
+    Vector lightPoint = basis.getDiskPoint(getPosition(), m_radius, x, y);
+
+    return Ray(point, lightPoint - point);
+}
+
 std::unique_ptr<Light> SphereLight::clone() const
 {
 	return std::make_unique<SphereLight>(*this);
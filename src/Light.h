@@ -3,9 +3,11 @@
 #include "Color.h"
 #include "Vector.h"
 #include "Ray.h"
+#include "OrthonormalBasis.h"
 #include "NamedEntity.h"
 #include "EntityDescriptionInterface.h"
 
+#include <memory>
 #include <random>
 
 class Light : public NamedEntity, public EntityDescriptionInterface1
@@ -40,6 +42,13 @@ public:
 
     virtual Ray getShadowRay(const Vector& point, bool distribution = false) const = 0;
 
+    //shadow ray towards the point of the light's surface that u and v in [0, 1) select
+    virtual Ray getShadowRay(const Vector& point, double u, double v) const = 0;
+
+    //same as above with the basis of the direction from the point to the light's center already built,
+    //so all samples of one shading point share it
+    virtual Ray getShadowRay(const Vector& point, const OrthonormalBasis& basis, double u, double v) const = 0;
+
 	virtual std::unique_ptr<Light> clone() const = 0;
 
     void setPosition(const Vector& position);
@@ -72,6 +81,10 @@ public:
 
     Ray getShadowRay(const Vector& point, bool distribution = false) const override;
 
+    Ray getShadowRay(const Vector& point, double u, double v) const override;
+
+    Ray getShadowRay(const Vector& point, const OrthonormalBasis& basis, double u, double v) const override;
+
     std::unique_ptr<Light> clone() const override;
 
 	std::string toDescription() const override;
@@ -85,7 +98,7 @@ private:
 
     double m_radius = 1.0;
 
-	static std::default_random_engine m_randomEngine;
+	static thread_local std::default_random_engine m_randomEngine;
 
 public:
 
@@ -109,6 +122,10 @@ public:
 
     Ray getShadowRay(const Vector& point, bool distribution = false) const override;
 
+    Ray getShadowRay(const Vector& point, double u, double v) const override;
+
+    Ray getShadowRay(const Vector& point, const OrthonormalBasis& basis, double u, double v) const override;
+
     std::unique_ptr<Light> clone() const override;
 
 	std::string toDescription() const override;
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cmath>
+
+#include "LightTree.h"
+
+LightTree::LightTree(const std::vector<Emitter>& emitters)
+	: m_emitters(emitters)
+{
+	if (m_emitters.empty())
+	{
+		return;
+	}
+
+	std::vector<int> lights(m_emitters.size());
+	for (size_t i = 0; i < lights.size(); ++i)
+	{
+		lights[i] = static_cast<int>(i);
+	}
+
+	m_nodes.reserve(2 * m_emitters.size() - 1);
+	build(lights, 0, lights.size());
+}
+
+int LightTree::build(std::vector<int>& lights, size_t begin, size_t end)
+{
+	int index = static_cast<int>(m_nodes.size());
+	m_nodes.emplace_back();
+
+	Node node;
+
+	if (end - begin == 1)
+	{
+		const Emitter& emitter = m_emitters[lights[begin]];
+		node.m_center = emitter.m_position;
+		node.m_radius = emitter.m_radius;
+		node.m_intensity = emitter.m_intensity;
+		node.m_light = lights[begin];
+		m_nodes[index] = node;
+
+		return index;
+	}
+
+	const Emitter& first = m_emitters[lights[begin]];
+	Vector minimum = first.m_position;
+	Vector maximum = first.m_position;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const Emitter& emitter = m_emitters[lights[i]];
+		const Vector& position = emitter.m_position;
+		double radius = emitter.m_radius;
+
+		minimum = Vector(std::min(minimum.m_x, position.m_x - radius), std::min(minimum.m_y, position.m_y - radius), std::min(minimum.m_z, position.m_z - radius));
+		maximum = Vector(std::max(maximum.m_x, position.m_x + radius), std::max(maximum.m_y, position.m_y + radius), std::max(maximum.m_z, position.m_z + radius));
+		node.m_intensity += emitter.m_intensity;
+	}
+
+	node.m_center = (minimum + maximum) / 2.0;
+	node.m_radius = (maximum - minimum).length() / 2.0;
+
+	//split at the median along the longest side of the bounds
+	Vector extent = maximum - minimum;
+	int axis = 0;
+	if (extent.m_y > extent.m_x && extent.m_y >= extent.m_z) axis = 1;
+	else if (extent.m_z > extent.m_x && extent.m_z > extent.m_y) axis = 2;
+
+	auto component = [this, axis](int light)
+	{
+		const Vector& position = m_emitters[light].m_position;
+		return axis == 0 ? position.m_x : (axis == 1 ? position.m_y : position.m_z);
+	};
+
+	size_t middle = begin + (end - begin) / 2;
+	std::nth_element(lights.begin() + begin, lights.begin() + middle, lights.begin() + end, [&component](int a, int b)
+	{
+		return component(a) < component(b);
+	});
+
+	node.m_left = build(lights, begin, middle);
+	node.m_right = build(lights, middle, end);
+	m_nodes[index] = node;
+
+	return index;
+}
+
+double LightTree::getImportance(const Node& node, const Vector& point, const Vector& normal)
+{
+	Vector toNode = node.m_center - point;
+	double distance = toNode.length();
+
+	if (distance <= node.m_radius)
+	{
+		return node.m_intensity;
+	}
+
+	double cosAngle = dot(toNode, normal) / distance;
+	double sinHalf = node.m_radius / distance;
+	double cosHalf = sqrt(1.0 - sinHalf * sinHalf);
+
+	if (cosAngle >= cosHalf)
+	{
+		return node.m_intensity;
+	}
+
+	//cosine between the normal and the direction into the sphere that comes closest to it
+	double sinAngle = sqrt(std::max(0.0, 1.0 - cosAngle * cosAngle));
+	double cosBound = cosAngle * cosHalf + sinAngle * sinHalf;
+
+	return node.m_intensity * std::max(0.0, cosBound);
+}
+
+void LightTree::cull(const Vector& point, const Vector& normal, double threshold, std::vector<LightSample>& lights) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	Vector unitNormal = normal;
+	unitNormal.normalize();
+
+	//the median split keeps the tree balanced, so the stack never gets deeper than twice its height
+	int stack[128];
+	int size = 0;
+
+	double rootImportance = getImportance(m_nodes[0], point, unitNormal);
+
+	if (rootImportance > 0.0 && rootImportance >= threshold)
+	{
+		stack[size++] = 0;
+	}
+
+	while (size > 0)
+	{
+		const Node& node = m_nodes[stack[--size]];
+
+		if (node.m_light >= 0)
+		{
+			lights.push_back({ node.m_light, 1.0 });
+			continue;
+		}
+
+		double left = getImportance(m_nodes[node.m_left], point, unitNormal);
+		double right = getImportance(m_nodes[node.m_right], point, unitNormal);
+
+		//the more important child goes on the stack last so it is opened first
+		int first = left >= right ? node.m_right : node.m_left;
+		int second = left >= right ? node.m_left : node.m_right;
+		double firstImportance = std::min(left, right);
+		double secondImportance = std::max(left, right);
+
+		if (firstImportance > 0.0 && firstImportance >= threshold)
+		{
+			stack[size++] = first;
+		}
+
+		if (secondImportance > 0.0 && secondImportance >= threshold)
+		{
+			stack[size++] = second;
+		}
+	}
+}
+
+bool LightTree::sample(const Vector& point, const Vector& normal, double u, LightSample& light) const
+{
+	if (m_nodes.empty())
+	{
+		return false;
+	}
+
+	Vector unitNormal = normal;
+	unitNormal.normalize();
+
+	double probability = 1.0;
+	int index = 0;
+
+	while (m_nodes[index].m_light < 0)
+	{
+		const Node& node = m_nodes[index];
+
+		double left = getImportance(m_nodes[node.m_left], point, unitNormal);
+		double right = getImportance(m_nodes[node.m_right], point, unitNormal);
+
+		if (left + right <= 0.0)
+		{
+			return false;
+		}
+
+		//u is rescaled to the chosen interval so it can pick again one level down
+		double leftProbability = left / (left + right);
+
+		if (u < leftProbability)
+		{
+			index = node.m_left;
+			u /= leftProbability;
+			probability *= leftProbability;
+		}
+		else
+		{
+			index = node.m_right;
+			u = (u - leftProbability) / (1.0 - leftProbability);
+			probability *= 1.0 - leftProbability;
+		}
+	}
+
+	if (getImportance(m_nodes[index], point, unitNormal) <= 0.0)
+	{
+		return false;
+	}
+
+	light = { m_nodes[index].m_light, 1.0 / probability };
+
+	return true;
+}
+
+size_t LightTree::getLightCount() const
+{
+	return m_emitters.size();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+
+#include "Vector.h"
+
+//binary hierarchy over the lights of a scene, every node bounds the lights below it with a sphere and sums their intensity,
+//so whole groups of lights that are behind a surface or too dim for it are skipped at once and the rest can be sampled by importance
+class LightTree
+{
+public:
+
+	//position, size and brightest color channel of one light
+	struct Emitter
+	{
+		Vector m_position;
+		double m_radius = 0.0;
+		double m_intensity = 0.0;
+	};
+
+	//a light chosen for a shading point, its contribution is scaled by the weight
+	struct LightSample
+	{
+		int m_light = 0;
+		double m_weight = 1.0;
+	};
+
+private:
+
+	struct Node
+	{
+		Vector m_center;
+		double m_radius = 0.0;
+		double m_intensity = 0.0;
+		int m_left = -1;
+		int m_right = -1;
+		int m_light = -1;
+	};
+
+	std::vector<Node> m_nodes;
+	std::vector<Emitter> m_emitters;
+
+	int build(std::vector<int>& lights, size_t begin, size_t end);
+
+	//upper bound of the light the node can add to a point with the given unit normal, the lights have no falloff,
+	//so it only depends on how far the node's bounding sphere rises above the point's horizon
+	static double getImportance(const Node& node, const Vector& point, const Vector& normal);
+
+public:
+
+	LightTree() = default;
+
+	explicit LightTree(const std::vector<Emitter>& emitters);
+
+	LightTree(const LightTree& other) = default;
+
+	LightTree(LightTree&& other) = default;
+
+	LightTree& operator=(const LightTree& other) = default;
+
+	LightTree& operator=(LightTree&& other) = default;
+
+	~LightTree() = default;
+
+	//every light whose bound reaches the threshold, nodes are opened in order of importance
+	void cull(const Vector& point, const Vector& normal, double threshold, std::vector<LightSample>& lights) const;
+
+	//walks down the tree choosing children with a probability proportional to their importance, u in [0, 1) selects the path,
+	//the weight of the chosen light is the inverse of its probability, returns false if no light can reach the point
+	bool sample(const Vector& point, const Vector& normal, double u, LightSample& light) const;
+
+	size_t getLightCount() const;
+};
@@ -1,6 +1,7 @@
 
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QRegion>
 
 #include "MainWindow.h"
 #include "SettingsIO.h"
@@ -15,10 +16,16 @@ MainWindow::MainWindow(QWidget *parent) :
     ui->setupUi(this);
 
     ui->statusBar->addWidget(&m_statusLabel);
+    ui->statusBar->addPermanentWidget(&m_previewLabel);
 
     ui->graphicsView->setScene(&m_graphicsScene);
-    m_pixmapItem = m_graphicsScene.addPixmap(QPixmap::fromImage(m_image));
+    m_imageItem = new ImageGraphicsItem();
+    m_graphicsScene.addItem(m_imageItem);
     ui->graphicsView->viewport()->installEventFilter(this);
+    ui->graphicsView->viewport()->setMouseTracking(true);
+
+    connect(&m_displayTimer, &QTimer::timeout, this, &MainWindow::updateDirtyTiles);
+    m_displayTimer.start(DISPLAY_INTERVAL);
 }
 
 MainWindow::~MainWindow()
@@ -46,8 +53,7 @@ void MainWindow::showEvent(QShowEvent* event)
 	emit cancelRendering();
 
     Application::m_rayTracer.setSize(ui->graphicsView->width(), ui->graphicsView->height());
-    m_image = QImage(Application::m_rayTracer.getWidth(), Application::m_rayTracer.getHeight(), QImage::Format_RGB32);
-    m_pixmapItem->setPixmap(QPixmap::fromImage(m_image));
+    resetImage();
 
 	ui->actionSaveImage->setEnabled(false);
 
@@ -79,8 +85,7 @@ void MainWindow::resizeEvent(QResizeEvent* event)
 	QResizeEvent* resizeEvent = static_cast<QResizeEvent*>(event);
 
 	Application::m_rayTracer.setSize(resizeEvent->size().width(), resizeEvent->size().height());
-	m_image = QImage(Application::m_rayTracer.getWidth(), Application::m_rayTracer.getHeight(), QImage::Format_RGB32);
-	m_pixmapItem->setPixmap(QPixmap::fromImage(m_image));
+	resetImage();
 
 	ui->actionSaveImage->setEnabled(false);
 
@@ -136,33 +141,107 @@ void MainWindow::onCameraRotatingStopped()
 	}
 }
 
-void MainWindow::onLineFinished()
-{
-    m_pixmapItem->setPixmap(QPixmap::fromImage(m_image));
-}
-
 void MainWindow::onRenderFinished(int microseconds)
 {
-	const unsigned char* imageData = Application::m_rayTracer.getPixmap();
-	m_image = QImage(imageData, Application::m_rayTracer.getWidth(), Application::m_rayTracer.getHeight(), QImage::Format_RGB32);
-	m_pixmapItem->setPixmap(QPixmap::fromImage(m_image));
+	updatePixmap();
 
 	ui->actionSaveImage->setEnabled(true);
 
 	m_statusLabel.setText("Rendering finished in " + QString::number(microseconds / 1000000.0, 'f', 2) + " s!");
 }
 
-void MainWindow::onRenderPreviewFinished()
+void MainWindow::onRefinementUpdated(int samples, double noise)
+{
+	updatePixmap();
+
+	m_statusLabel.setText("Refining... " + QString::number(samples) + " samples per pixel, noise " + QString::number(noise, 'f', 4));
+}
+
+void MainWindow::onRefinementFinished(int samples, double noise)
+{
+	updatePixmap();
+
+	m_statusLabel.setText("Refinement finished with " + QString::number(samples) + " samples per pixel, noise " + QString::number(noise, 'f', 4));
+}
+
+void MainWindow::onRenderCancelled(int microseconds)
+{
+	m_statusLabel.setToolTip("Last cancellation took " + QString::number(microseconds / 1000.0, 'f', 2) + " ms, max " 
+		+ QString::number(Application::m_concurrencyHandler.getMaxCancelLatency() / 1000.0, 'f', 2) + " ms");
+}
+
+void MainWindow::onRenderPreviewFinished(int microseconds, int subSamplingSize)
 {
-	const unsigned char* imageData = Application::m_rayTracer.getPixmap();
-	m_image = QImage(imageData, Application::m_rayTracer.getWidth(), Application::m_rayTracer.getHeight(), QImage::Format_RGB32);
-	m_pixmapItem->setPixmap(QPixmap::fromImage(m_image));
+	updatePixmap();
+
+	m_previewLabel.setText("Preview 1/" + QString::number(subSamplingSize) + " in " + QString::number(microseconds / 1000.0, 'f', 1) + " ms");
+}
+
+void MainWindow::updatePixmap()
+{
+	//the whole image is replaced, so the tiles waiting for the next update are already part of it
+	Application::m_concurrencyHandler.takeDirtyTiles();
+
+	//the front image is only valid while it is locked, so an owned copy is kept for display and saving
+	Application::m_rayTracer.readFrontImage([this](const Image& image)
+	{
+		if (image.getPixmap() == nullptr)
+		{
+			return;
+		}
+
+		if (image.getWidth() == m_imageItem->getImage().width() && image.getHeight() == m_imageItem->getImage().height())
+		{
+			m_imageItem->updateRegion(image.getPixmap(), image.getWidth(), image.getHeight(), QRect(0, 0, image.getWidth(), image.getHeight()));
+		}
+		else
+		{
+			m_imageItem->setImage(QImage(image.getPixmap(), image.getWidth(), image.getHeight(), QImage::Format_RGB32).copy());
+		}
+	});
+}
+
+void MainWindow::updateDirtyTiles()
+{
+	std::vector<Tile> dirtyTiles = Application::m_concurrencyHandler.takeDirtyTiles();
+
+	if (dirtyTiles.empty())
+	{
+		return;
+	}
+
+	//neighbouring tiles are merged into larger rectangles
+	QRegion region;
+	for (const Tile& tile : dirtyTiles)
+	{
+		region += QRect(tile.m_x, tile.m_y, tile.m_width, tile.m_height);
+	}
+
+	Application::m_rayTracer.readFrontImage([this, &region](const Image& image)
+	{
+		for (const QRect& rect : region)
+		{
+			m_imageItem->updateRegion(image.getPixmap(), image.getWidth(), image.getHeight(), rect);
+		}
+	});
+}
+
+void MainWindow::resetImage()
+{
+	QImage image(Application::m_rayTracer.getWidth(), Application::m_rayTracer.getHeight(), QImage::Format_RGB32);
+	image.fill(Qt::black);
+
+	m_imageItem->setImage(image);
+
+	Application::m_concurrencyHandler.takeDirtyTiles();
 }
 
 void MainWindow::onRedraw()
 {
 	ui->actionSaveImage->setEnabled(false);
 
+	m_statusLabel.setText("Rendering...");
+
 	emit render();
 }
 
@@ -185,7 +264,7 @@ void MainWindow::on_actionSaveScene_triggered()
 		"Text files (*.txt)",
 		&selectedFilter);
 
-	SettingsIO::saveSettings(fileName.toStdString());
+	SettingsIO::saveSettings(fileName.toStdString(), Application::m_scene, Application::m_rayTracer);
 }
 
 void MainWindow::on_actionLoadScene_triggered()
@@ -203,7 +282,12 @@ void MainWindow::on_actionLoadScene_triggered()
 
 	emit cancelRendering();
 
-	SettingsIO::loadSettings(fileName.toStdString());
+	SettingsIO::loadSettings(fileName.toStdString(), Application::m_scene, Application::m_rayTracer);
+
+	Application::m_keyEventHandler.init(Application::m_scene.getCamera());
+	Application::m_mouseEventHandler.init(Application::m_scene.getCamera());
+
+	emit sceneLoaded();
 	
 	Application::m_settingsWindow->loadSettings();
 
@@ -233,7 +317,7 @@ void MainWindow::on_actionSaveImage_triggered()
 
 	if (!filename.isEmpty())
 	{
-		if (!m_image.save(filename))
+		if (!m_imageItem->getImage().save(filename))
 		{
 			QMessageBox::critical(this, "Error!", "Unable to save to file\n" + filename);
 		}
@@ -3,10 +3,12 @@
 #include <QMainWindow>
 #include <QImage>
 #include <QGraphicsScene>
-#include <QGraphicspixmapItem>
 #include <QShowEvent>
 #include <QResizeEvent>
 #include <QLabel>
+#include <QTimer>
+
+#include "ImageGraphicsItem.h"
 
 namespace Ui {
 class MainWindow;
@@ -52,14 +54,24 @@ private slots:
 
 	void on_actionSaveImage_triggered();
 
+	//uploads the tiles finished since the last update, runs at a fixed rate so the cost does not depend on the tile count
+	void updateDirtyTiles();
+
 private:
 
     Ui::MainWindow* ui;
 
     QGraphicsScene m_graphicsScene;
-    QImage m_image;
-    QGraphicsPixmapItem* m_pixmapItem;
+    ImageGraphicsItem* m_imageItem;
     QLabel m_statusLabel;
+    QLabel m_previewLabel;
+    QTimer m_displayTimer;
+
+	static constexpr int DISPLAY_INTERVAL = 33;
+
+	void updatePixmap();
+
+	void resetImage();
 
 public slots:
 
@@ -71,12 +83,16 @@ public slots:
 
 	void onCameraRotatingStopped();
 
-    void onLineFinished();
-
-	void onRenderPreviewFinished();
+	void onRenderPreviewFinished(int microseconds, int subSamplingSize);
 
 	void onRenderFinished(int microseconds);
 
+	void onRefinementUpdated(int samples, double noise);
+
+	void onRefinementFinished(int samples, double noise);
+
+	void onRenderCancelled(int microseconds);
+
     void onRedraw();
 
 signals:
@@ -86,4 +102,6 @@ signals:
 	void render();
 
 	void cancelRendering();
+
+	void sceneLoaded();
 };
@@ -1,6 +1,7 @@
 #include "Model.h"
 #include "Utility.h"
 
+#include <algorithm>
 #include <sstream>
 
 std::string Model::DESCRIPTION_LABEL = "Model";
@@ -36,9 +36,17 @@ bool MouseEventHandler::eventFilter(QObject* obj, QEvent* event)
 	}
 	else if (event->type() == QEvent::MouseMove)
 	{
-		if (!Application::m_concurrencyHandler.isRendering())
+		QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+
+		//hovering only tells the ray tracer which tiles to render first
+		if (mouseEvent->buttons() == Qt::NoButton)
+		{
+			QPointF scenePos = Application::m_mainWindow->getGraphicsView()->mapToScene(mouseEvent->pos());
+
+			emit regionOfInterestChanged(static_cast<int>(scenePos.x()), static_cast<int>(scenePos.y()));
+		}
+		else if (!Application::m_concurrencyHandler.isRendering())
 		{
-			QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
 			if (mouseEvent->buttons() & Qt::LeftButton)
 			{
 				QPointF delta = mouseEvent->pos() - m_lastLeftMousePos;
@@ -36,6 +36,8 @@ signals:
 
 	void cameraRotatingStopped();
 
+	void regionOfInterestChanged(int x, int y);
+
 protected:
 
 	Camera* m_camera = nullptr;
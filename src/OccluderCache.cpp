@@ -0,0 +1,77 @@
+#include "OccluderCache.h"
+
+void OccluderCache::prepare(const CompiledScene& scene)
+{
+	if (m_sceneId != scene.getId())
+	{
+		m_sceneId = scene.getId();
+		m_occluders.assign(scene.getLights().size(), nullptr);
+	}
+}
+
+bool OccluderCache::isOccluded(const CompiledScene& scene, const Ray& ray, int light, const CancellationToken& cancellationToken)
+{
+	m_lookups++;
+
+	const ComponentShape* cached = m_occluders[light];
+
+	if (cached != nullptr && occludes(cached, ray))
+	{
+		m_hits++;
+		m_occluded++;
+		return true;
+	}
+
+	for (const ComponentShape* shape : scene.getShapes())
+	{
+		if (cancellationToken.isCancelled())
+		{
+			break;
+		}
+
+		if (shape != cached && occludes(shape, ray))
+		{
+			m_occluders[light] = shape;
+			m_occluded++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const ComponentShape* OccluderCache::getOccluder(int light) const
+{
+	return m_occluders[light];
+}
+
+void OccluderCache::setOccluder(int light, const ComponentShape* shape)
+{
+	m_occluders[light] = shape;
+}
+
+void OccluderCache::count(int64_t lookups, int64_t hits, int64_t occluded)
+{
+	m_lookups += lookups;
+	m_hits += hits;
+	m_occluded += occluded;
+}
+
+void OccluderCache::takeStatistics(int64_t& lookups, int64_t& hits, int64_t& occluded)
+{
+	lookups = m_lookups;
+	hits = m_hits;
+	occluded = m_occluded;
+
+	m_lookups = 0;
+	m_hits = 0;
+	m_occluded = 0;
+}
+
+bool OccluderCache::occludes(const ComponentShape* shape, const Ray& ray)
+{
+	//the direction of a shadow ray reaches the light at t = 1
+	Intersection intersection = shape->getIntersection(ray);
+
+	return intersection.m_t > 0.0 && intersection.m_t <= 1.0 && intersection.m_material != nullptr;
+}
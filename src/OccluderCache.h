@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "CompiledScene.h"
+#include "ComponentShape.h"
+#include "Ray.h"
+
+//remembers the last shape that blocked a shadow ray towards each light, neighbouring shading points are usually shadowed 
+//by the same shape, so it is tested before the rest of the scene, every render thread keeps its own
+class OccluderCache
+{
+private:
+
+	uint64_t m_sceneId = 0;
+	std::vector<const ComponentShape*> m_occluders;
+	int64_t m_lookups = 0;
+	int64_t m_hits = 0;
+	int64_t m_occluded = 0;
+
+public:
+
+	OccluderCache() = default;
+
+	OccluderCache(const OccluderCache& other) = default;
+
+	OccluderCache(OccluderCache&& other) = default;
+
+	OccluderCache& operator=(const OccluderCache& other) = default;
+
+	OccluderCache& operator=(OccluderCache&& other) = default;
+
+	~OccluderCache() = default;
+
+	//forgets the occluders when a different scene is rendered, the shapes of the old one may no longer exist
+	void prepare(const CompiledScene& scene);
+
+	//whether anything lies between the origin of the shadow ray and the light at t = 1, prepare() has to be called first
+	bool isOccluded(const CompiledScene& scene, const Ray& ray, int light, const CancellationToken& cancellationToken);
+
+	const ComponentShape* getOccluder(int light) const;
+
+	void setOccluder(int light, const ComponentShape* shape);
+
+	void count(int64_t lookups, int64_t hits, int64_t occluded);
+
+	//shadow rays tested, answered by the cached shape and blocked at all since the last call
+	void takeStatistics(int64_t& lookups, int64_t& hits, int64_t& occluded);
+
+	static bool occludes(const ComponentShape* shape, const Ray& ray);
+};
@@ -71,6 +71,27 @@ Ray OrthoCamera::getRay(int screenWidth, int screenHeight, double x, double y) c
 	return Ray(m_position + pixelCameraX * m_right + pixelCameraY * m_up, m_direction);
 }
 
+bool OrthoCamera::project(int screenWidth, int screenHeight, const Vector& point, double& x, double& y) const
+{
+	Vector toPoint = point - m_position;
+
+	if (dot(toPoint, m_direction) < 0)
+	{
+		return false;
+	}
+
+	double aspectRatio = static_cast<double>(screenWidth) / static_cast<double>(screenHeight);
+
+	//-1...1
+	double pixelScreenX = dot(toPoint, m_right) / ((m_orthoWidth / 2) * aspectRatio);
+	double pixelScreenY = dot(toPoint, m_up) / (m_orthoHeight / 2);
+
+	x = (pixelScreenX + 1) / 2 * screenWidth;
+	y = (1 - pixelScreenY) / 2 * screenHeight;
+
+	return true;
+}
+
 std::unique_ptr<Camera> OrthoCamera::clone() const
 {
 	return std::make_unique<OrthoCamera>(*this);
@@ -0,0 +1,59 @@
+#include <cmath>
+
+#include "OrthonormalBasis.h"
+
+OrthonormalBasis::OrthonormalBasis()
+	: m_tangent(1.0, 0.0, 0.0)
+	, m_bitangent(0.0, 1.0, 0.0)
+	, m_normal(0.0, 0.0, 1.0)
+{
+
+}
+
+OrthonormalBasis::OrthonormalBasis(const Vector& direction)
+	: OrthonormalBasis()
+{
+	double length = direction.length();
+
+	if (length == 0.0)
+	{
+		return;
+	}
+
+	double x = direction.m_x / length;
+	double y = direction.m_y / length;
+	double z = direction.m_z / length;
+
+	double sign = std::copysign(1.0, z);
+	double a = -1.0 / (sign + z);
+	double b = x * y * a;
+
+	m_normal = Vector(x, y, z);
+	m_tangent = Vector(1.0 + sign * x * x * a, sign * b, -sign * x);
+	m_bitangent = Vector(b, sign + y * y * a, -y);
+}
+
+const Vector& OrthonormalBasis::getTangent() const
+{
+	return m_tangent;
+}
+
+const Vector& OrthonormalBasis::getBitangent() const
+{
+	return m_bitangent;
+}
+
+const Vector& OrthonormalBasis::getNormal() const
+{
+	return m_normal;
+}
+
+Vector OrthonormalBasis::getDiskPoint(const Vector& center, double radius, double x, double y) const
+{
+	double s = radius * x;
+	double t = radius * y;
+
+	return Vector(center.m_x + s * m_tangent.m_x + t * m_bitangent.m_x,
+		center.m_y + s * m_tangent.m_y + t * m_bitangent.m_y,
+		center.m_z + s * m_tangent.m_z + t * m_bitangent.m_z);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Vector.h"
+
+//tangent, bitangent and normal of a direction, built once per shading point so every sample on the disk around it
+//only costs a few multiply-adds
+class OrthonormalBasis
+{
+private:
+
+	Vector m_tangent;
+	Vector m_bitangent;
+	Vector m_normal;
+
+public:
+
+	OrthonormalBasis();
+
+	//the normal points along the direction, the other two axes follow without branches or square roots (Duff et al.)
+	explicit OrthonormalBasis(const Vector& direction);
+
+	OrthonormalBasis(const OrthonormalBasis& other) = default;
+
+	OrthonormalBasis(OrthonormalBasis&& other) = default;
+
+	OrthonormalBasis& operator=(const OrthonormalBasis& other) = default;
+
+	OrthonormalBasis& operator=(OrthonormalBasis&& other) = default;
+
+	~OrthonormalBasis() = default;
+
+	const Vector& getTangent() const;
+
+	const Vector& getBitangent() const;
+
+	const Vector& getNormal() const;
+
+	//center + radius * (x * tangent + y * bitangent)
+	Vector getDiskPoint(const Vector& center, double radius, double x, double y) const;
+};
@@ -59,6 +59,28 @@ Ray PerspectiveCamera::getRay(int screenWidth, int screenHeight, double x, doubl
 	return Ray(m_position, (m_direction + pixelCameraX * m_right + pixelCameraY * m_up).normalize());
 }
 
+bool PerspectiveCamera::project(int screenWidth, int screenHeight, const Vector& point, double& x, double& y) const
+{
+	Vector toPoint = point - m_position;
+
+	double depth = dot(toPoint, m_direction);
+	if (depth <= 0.000001)
+	{
+		return false;
+	}
+
+	double aspectRatio = static_cast<double>(screenWidth) / static_cast<double>(screenHeight);
+
+	//-1...1
+	double pixelScreenX = (dot(toPoint, m_right) / depth) / (aspectRatio * tan(m_fov / 2));
+	double pixelScreenY = (dot(toPoint, m_up) / depth) / tan(m_fov / 2);
+
+	x = (pixelScreenX + 1) / 2 * screenWidth;
+	y = (1 - pixelScreenY) / 2 * screenHeight;
+
+	return true;
+}
+
 std::unique_ptr<Camera> PerspectiveCamera::clone() const
 {
 	return std::make_unique<PerspectiveCamera>(*this);
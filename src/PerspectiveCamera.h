@@ -17,6 +17,8 @@ public:
 
 	Ray getRay(int screenWidth, int screenHeight, double x, double y) const override;
 
+	bool project(int screenWidth, int screenHeight, const Vector& point, double& x, double& y) const override;
+
 	std::unique_ptr<Camera> clone() const override;
 
 	std::string toDescription() const override;
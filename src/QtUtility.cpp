@@ -0,0 +1,19 @@
+#include "QtUtility.h"
+
+Color QtUtility::styleSheetToColor(const QString& styleSheet) 
+{
+	QStringRef name(&styleSheet, styleSheet.indexOf('#'), 7);
+	QColor color = QColor(name.toString());
+	return Color(color.red() / 255.0, color.green() / 255.0, color.blue() / 255.0);
+}
+
+QColor QtUtility::styleSheetToQColor(const QString& styleSheet) 
+{
+	QStringRef name(&styleSheet, styleSheet.indexOf('#'), 7);
+	return QColor(name.toString());
+}
+
+QColor QtUtility::colorToQColor(const Color& color) 
+{
+	return QColor(color.m_red * 255, color.m_green * 255, color.m_blue * 255);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QColor>
+#include <QString>
+
+#include "Color.h"
+
+class QtUtility
+{
+public:
+
+	static Color styleSheetToColor(const QString& styleSheet);
+
+	static QColor styleSheetToQColor(const QString& styleSheet);
+
+	static QColor colorToQColor(const Color& color);
+};
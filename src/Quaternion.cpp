@@ -52,6 +52,90 @@ Matrix Quaternion::getMatrix(double degrees, const Vector& axis)
     return matrix;
 }
 
+Quaternion Quaternion::fromBasis(const Vector& right, const Vector& up, const Vector& back)
+{
+	//the basis vectors are the columns of the rotation matrix
+	double trace = right.m_x + up.m_y + back.m_z;
+
+	Quaternion result;
+
+	if (trace > 0.0)
+	{
+		double s = 0.5 / sqrt(trace + 1.0);
+		result.m_w = 0.25 / s;
+		result.m_x = (up.m_z - back.m_y) * s;
+		result.m_y = (back.m_x - right.m_z) * s;
+		result.m_z = (right.m_y - up.m_x) * s;
+	}
+	else if (right.m_x > up.m_y && right.m_x > back.m_z)
+	{
+		double s = 2.0 * sqrt(1.0 + right.m_x - up.m_y - back.m_z);
+		result.m_w = (up.m_z - back.m_y) / s;
+		result.m_x = 0.25 * s;
+		result.m_y = (up.m_x + right.m_y) / s;
+		result.m_z = (back.m_x + right.m_z) / s;
+	}
+	else if (up.m_y > back.m_z)
+	{
+		double s = 2.0 * sqrt(1.0 + up.m_y - right.m_x - back.m_z);
+		result.m_w = (back.m_x - right.m_z) / s;
+		result.m_x = (up.m_x + right.m_y) / s;
+		result.m_y = 0.25 * s;
+		result.m_z = (back.m_y + up.m_z) / s;
+	}
+	else
+	{
+		double s = 2.0 * sqrt(1.0 + back.m_z - right.m_x - up.m_y);
+		result.m_w = (right.m_y - up.m_x) / s;
+		result.m_x = (back.m_x + right.m_z) / s;
+		result.m_y = (back.m_y + up.m_z) / s;
+		result.m_z = 0.25 * s;
+	}
+
+	return result;
+}
+
+Quaternion Quaternion::slerp(const Quaternion& from, const Quaternion& to, double t)
+{
+	double cosAngle = from.m_w * to.m_w + from.m_x * to.m_x + from.m_y * to.m_y + from.m_z * to.m_z;
+
+	//q and -q are the same rotation, the shorter arc is taken
+	double sign = 1.0;
+	if (cosAngle < 0.0)
+	{
+		cosAngle = -cosAngle;
+		sign = -1.0;
+	}
+
+	double fromWeight = 1.0 - t;
+	double toWeight = t;
+
+	//nearly parallel quaternions fall back to linear interpolation
+	if (cosAngle < 0.9995)
+	{
+		double angle = acos(cosAngle);
+		double sinAngle = sin(angle);
+		fromWeight = sin((1.0 - t) * angle) / sinAngle;
+		toWeight = sin(t * angle) / sinAngle;
+	}
+
+	toWeight *= sign;
+
+	Quaternion result;
+	result.m_w = fromWeight * from.m_w + toWeight * to.m_w;
+	result.m_x = fromWeight * from.m_x + toWeight * to.m_x;
+	result.m_y = fromWeight * from.m_y + toWeight * to.m_y;
+	result.m_z = fromWeight * from.m_z + toWeight * to.m_z;
+
+	double length = sqrt(result.m_w * result.m_w + result.m_x * result.m_x + result.m_y * result.m_y + result.m_z * result.m_z);
+	result.m_w /= length;
+	result.m_x /= length;
+	result.m_y /= length;
+	result.m_z /= length;
+
+	return result;
+}
+
 Quaternion Quaternion::operator*(const Quaternion& rhs)
 {
 	Quaternion result;
@@ -23,6 +23,11 @@ public:
 
     static Matrix getMatrix(double degrees, const Vector& axis);
 
+	//rotation that takes the x, y and z axes to the given orthonormal basis
+	static Quaternion fromBasis(const Vector& right, const Vector& up, const Vector& back);
+
+	static Quaternion slerp(const Quaternion& from, const Quaternion& to, double t);
+
 	Quaternion operator*(const Quaternion& rhs);
 
 	Quaternion& operator*=(const Quaternion& rhs);
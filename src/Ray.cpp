@@ -1,13 +1,15 @@
 
+#include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <thread>
 
 #include "Ray.h"
 #include "Constants.h"
-#include "Quaternion.h"
-#include "Matrix.h"
+#include "Sampler.h"
 
-std::default_random_engine Ray::m_randomEngine(std::chrono::system_clock::now().time_since_epoch().count());
+//every render thread gets its own engine, the thread id keeps threads started in the same clock tick apart
+thread_local std::default_random_engine Ray::m_randomEngine(std::chrono::system_clock::now().time_since_epoch().count() ^ std::hash<std::thread::id>()(std::this_thread::get_id()));
 
 Ray::Ray(const Vector& start, const Vector& direction)
     : m_origin(start)
@@ -83,24 +85,68 @@ Ray Ray::distribute(double degrees) const
     {
         return *this;
     }
-    else
+
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    double u = distribution(m_randomEngine);
+    double v = distribution(m_randomEngine);
+
+    return distribute(degrees, u, v);
+}
+
+Ray Ray::distribute(double degrees, double u, double v) const
+{
+    if (degrees == 0.0)
+    {
+        return *this;
+    }
+
+    return distribute(OrthonormalBasis(m_direction), getConeRadius(degrees), u, v);
+}
+
+Ray Ray::distribute(const OrthonormalBasis& basis, double radius, double u, double v) const
+{
+    if (radius == 0.0)
+    {
+        return *this;
+    }
+
+    double x;
+    double y;
+    Sampler::toDisk(u, v, x, y);
+
+    Vector endPoint = basis.getDiskPoint(getPoint(1.0), radius, x, y);
+
+    return Ray(m_origin, endPoint - m_origin);
+}
+
+Ray Ray::distribute(const OrthonormalBasis& basis, double radius, const Vector& side, double u, double v) const
+{
+    if (radius == 0.0)
     {
-        double radius = tan((degrees / 2) * (Constants::PI / 180));
-        Vector position = getPoint(1.0);
-        const Vector& point = getOrigin();
-
-		std::uniform_int_distribution<int> distribution1(1, 100);
-		double rad = distribution1(m_randomEngine) * 0.01 * radius;
-		Vector perp = normalize(perpendicular(position - point));
-		double ratio = (2 * Constants::PI * rad) / (2 * Constants::PI * radius);
-		std::uniform_int_distribution<int> distribution2(0, static_cast<int>(360 * ratio) - 1);
-		int pt = distribution2(m_randomEngine);
-		double angle = pt * (360 / ratio);
-		Matrix mat = Quaternion::getMatrix(angle, Vector(position - point));
-		perp = normalize(mat * perp);
-
-        Vector endPoint = position + (rad * perp);
-
-        return Ray(point, endPoint - point);
+        return *this;
     }
+
+    double x;
+    double y;
+    Sampler::toDisk(u, v, x, y);
+
+    //how far the disk's center and its two axes reach along the side vector
+    double height = dot(m_direction, side);
+    double slopeX = radius * dot(basis.getTangent(), side);
+    double slopeY = radius * dot(basis.getBitangent(), side);
+    double slope = sqrt(slopeX * slopeX + slopeY * slopeY);
+
+    if (slope > height)
+    {
+        Sampler::toDiskSegment(slopeX / slope, slopeY / slope, std::max(0.0, height / slope), x, y);
+    }
+
+    Vector endPoint = basis.getDiskPoint(getPoint(1.0), radius, x, y);
+
+    return Ray(m_origin, endPoint - m_origin);
+}
+
+double Ray::getConeRadius(double degrees)
+{
+    return tan((degrees / 2) * (Constants::PI / 180));
 }
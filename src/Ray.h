@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Vector.h"
+#include "OrthonormalBasis.h"
 
 #include <random>
 
@@ -11,7 +12,7 @@ private:
     Vector m_origin;
     Vector m_direction;
 
-	static std::default_random_engine m_randomEngine;
+	static thread_local std::default_random_engine m_randomEngine;
 
 public:
 
@@ -46,4 +47,18 @@ public:
     Ray refract(const Vector& point, const Vector& normal, double n2, bool out) const;
 
     Ray distribute(double degrees) const;
+
+    //the direction moved to the point of the cone's base disk that u and v in [0, 1) select
+    Ray distribute(double degrees, double u, double v) const;
+
+    //same as above for a basis built from this ray's direction and the cone radius of the angle,
+    //so the samples of one shading point share both
+    Ray distribute(const OrthonormalBasis& basis, double radius, double u, double v) const;
+
+    //same as above keeping the direction on the side of the plane through the origin that the side vector points to,
+    //the part of the cone's base disk behind the plane is never sampled, so no direction has to be drawn again
+    Ray distribute(const OrthonormalBasis& basis, double radius, const Vector& side, double u, double v) const;
+
+    //radius of the base disk, one unit of direction away from the origin, of a cone with the given opening angle
+    static double getConeRadius(double degrees);
 };
@@ -1,19 +1,40 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <sstream>
+#include <thread>
 
 #include "RayTracer.h"
 #include "Utility.h"
+#include "WavefrontTracer.h"
 
 std::string RayTracer::DESCRIPTION_LABEL = "RayTracer";
 
-Color RayTracer::traceRay(const Ray& ray, int recursion) const
+thread_local OccluderCache RayTracer::m_occluderCache;
+thread_local bool RayTracer::m_rayBudgetCapped = false;
+thread_local int64_t RayTracer::m_tracedRays = 0;
+
+Color RayTracer::traceRay(const CompiledScene& scene, const SamplePath& path, const Ray& ray, int recursion, double budget, double throughput, double* hitDistance) const
 {
-    Intersection intersection = getIntersection(ray);
+    //the result of a cancelled render is thrown away, so unwinding quickly matters more than the color
+    if (m_cancellationToken.isCancelled())
+    {
+        return m_backgroundColor;
+    }
+
+    m_tracedRays++;
+
+    Intersection intersection = getIntersection(scene, ray);
 
     if (intersection.type != Intersection::IntersectionType::NONE && intersection.m_material != nullptr)
     {
+        if (hitDistance != nullptr)
+        {
+            *hitDistance = intersection.m_t;
+        }
+
         Color color = Color(0.0, 0.0, 0.0);
 
         Vector point = ray.getPoint(intersection.m_t);
@@ -24,28 +45,107 @@ Color RayTracer::traceRay(const Ray& ray, int recursion) const
         //ambient
         color += materialProperties.m_ambient;
 
-        //lights
-		std::vector<Light*> lights = m_scene->getLights();
-        for (const Light* light : lights)
+        //every light and the reflection and refraction draw from their own sample dimension
+        const Sampler& sampler = Sampler::get(m_samplerType);
+        const std::vector<CompiledScene::CompiledLight>& lights = scene.getLights();
+        const int reflectionDimension = static_cast<int>(lights.size());
+        const int refractionDimension = reflectionDimension + 1;
+
+        //lights, only the ones that can add enough or a few sampled by importance when the scene has many
+        static thread_local std::vector<LightTree::LightSample> selectedLights;
+        selectLights(scene.getLightTree(), sampler, path, point, normal, materialProperties, m_lightThreshold, m_lightSampleCount, selectedLights);
+
+        //with Fresnel selection a transparent surface continues along only one of its two rays
+        double reflectance = materialProperties.m_reflectance;
+        double transparency = materialProperties.m_transparency;
+
+        if (m_fresnelSelection == true && m_previewMode == false && transparency > 0 && recursion > 0)
+        {
+            selectFresnelBranch(path, ray.getDirection(), normal, intersection.m_material->getProperties().m_refractionIndex,
+                intersection.type == Intersection::IntersectionType::OUT, reflectance, transparency);
+        }
+
+        //the ray budget can lower the counts of this point and is shared by the reflected and refracted rays
+        int shadowDist = m_previewMode == false ? m_shadowDist : 1;
+        int reflectionCount = m_previewMode == false && reflectance > 0 && recursion > 0 ? m_reflectionDist : 0;
+        int refractionCount = m_previewMode == false && transparency > 0 && recursion > 0 ? m_refractionDist : 0;
+        double reflectionBudget = budget;
+        double refractionBudget = budget;
+
+        if (std::isfinite(budget))
         {
-            if (!light->isEnabled())
+            int softLightCount = 0;
+
+            for (const LightTree::LightSample& selectedLight : selectedLights)
             {
-                continue;
+                if (lights[selectedLight.m_light].m_type == CompiledScene::LightType::SPHERE)
+                {
+                    softLightCount++;
+                }
+            }
+
+            if (splitRayBudget(budget, static_cast<int>(selectedLights.size()), softLightCount, shadowDist, reflectionCount, reflectionBudget, refractionCount, refractionBudget))
+            {
+                m_rayBudgetCapped = true;
             }
+        }
 
-            const Color& lightColor = light->getColor();
+        for (const LightTree::LightSample& selectedLight : selectedLights)
+        {
+            const int l = selectedLight.m_light;
+            const CompiledScene::CompiledLight& light = lights[l];
+            const Color& lightColor = light.m_color;
 
             Color colorSum;
             int shadowRayCount = 1;
 
-            if (m_previewMode == false && dynamic_cast<const SphereLight*>(light) != nullptr && m_shadowDist > 1)
+            if (light.m_type == CompiledScene::LightType::SPHERE && shadowDist > 1)
+            {
+                shadowRayCount = shadowDist;
+            }
+
+            //a few probe rays spread over the whole light come first, the rest of the budget is only spent 
+            //if they disagree about whether the light is visible
+            int probeRayCount = shadowRayCount;
+
+            if (m_adaptiveShadows == true && shadowRayCount > SHADOW_PROBE_RAYS)
+            {
+                probeRayCount = SHADOW_PROBE_RAYS;
+            }
+
+            int sampleCount = 0;
+            int litCount = 0;
+            int tracedCount = 0;
+
+            OrthonormalBasis lightBasis;
+            if (shadowRayCount > 1)
             {
-                shadowRayCount = m_shadowDist;
+                lightBasis = OrthonormalBasis(light.m_light->getPosition() - point);
             }
 
-            for (int j = 0; j < shadowRayCount; ++j)
+            for (int j = 0; j < shadowRayCount && !m_cancellationToken.isCancelled(); ++j)
             {
-                Ray shadowRay = light->getShadowRay(point, shadowRayCount > 1);
+                if (j == probeRayCount && (litCount == 0 || litCount == probeRayCount))
+                {
+                    break;
+                }
+
+                sampleCount++;
+
+                Ray shadowRay;
+
+                if (shadowRayCount > 1)
+                {
+                    double u;
+                    double v;
+                    getShadowSample(sampler, path, l, j, probeRayCount, shadowRayCount, u, v);
+                    shadowRay = light.m_light->getShadowRay(point, lightBasis, u, v);
+                }
+                else
+                {
+                    shadowRay = light.m_light->getShadowRay(point, false);
+                }
+
                 shadowRay.shiftOrigin();
 
                 if (dot(shadowRay.getDirection(), normal) < 0)
@@ -53,10 +153,18 @@ Color RayTracer::traceRay(const Ray& ray, int recursion) const
                     continue;
                 }
 
-                Intersection shadowIntersection = getIntersection(shadowRay);
+                bool lit = true;
+
+                if (m_previewMode == false || m_previewShadows == true)
+                {
+                    lit = !isOccluded(scene, shadowRay, l);
+                    tracedCount++;
+                }
 
-                if (shadowIntersection.m_t == 0 || shadowIntersection.m_t > 1)
+                if (lit)
                 {
+                    litCount++;
+
                     //diffuse
                     Vector lightDir = shadowRay.getDirection();
                     lightDir.normalize();
@@ -77,42 +185,64 @@ Color RayTracer::traceRay(const Ray& ray, int recursion) const
                 }
             }
 
-            color += colorSum / shadowRayCount;
+            if (shadowRayCount > 1)
+            {
+                countSoftShadowRays(1, tracedCount);
+            }
+
+            color += colorSum * (selectedLight.m_weight / std::max(1, sampleCount));
         }
 
         //reflected ray
-        if (m_previewMode == false && materialProperties.m_reflectance > 0 && recursion > 0)
+        if (reflectionCount > 0)
         {
             Ray reflectedRay = ray.reflect(point, normal);
             reflectedRay.shiftOrigin();
 
+            double reflectedThroughput = throughput * reflectance;
+
             if (m_reflectionDist == 1)
             {
-                Color reflectedColor = traceRay(reflectedRay, recursion - 1);
-                color += reflectedColor * materialProperties.m_reflectance;
+                SamplePath reflectedPath = path.child(reflectionDimension, 0);
+                double survival = getSurvivalProbability(reflectedPath, reflectedThroughput, m_minThroughput, m_russianRoulette);
+
+                if (survival > 0.0)
+                {
+                    Color reflectedColor = traceRay(scene, reflectedPath, reflectedRay, recursion - 1, reflectionBudget, reflectedThroughput / survival);
+                    color += reflectedColor * (reflectance / survival);
+                }
             }
             else
             {
                 Color colorSum;
 
-                for (int i = 0; i < m_reflectionDist; ++i)
+                OrthonormalBasis reflectionBasis(reflectedRay.getDirection());
+                double reflectionRadius = Ray::getConeRadius(materialProperties.m_reflectionDistAngle);
+                Vector reflectionSide = dot(reflectedRay.getDirection(), normal) >= 0 ? normal : -normal;
+
+                for (int i = 0; i < reflectionCount && !m_cancellationToken.isCancelled(); ++i)
                 {
-                    Ray distRay = reflectedRay.distribute(materialProperties.m_reflectionDistAngle);
-                    if (dot(distRay.getDirection(), normal) < 0)
+                    //the cone is cut at the surface, so every sample leaves on the side the reflection does
+                    double u;
+                    double v;
+                    sampler.get2D(path, reflectionDimension, i, reflectionCount, u, v);
+                    Ray distRay = reflectedRay.distribute(reflectionBasis, reflectionRadius, reflectionSide, u, v);
+                    SamplePath reflectedPath = path.child(reflectionDimension, i);
+                    double survival = getSurvivalProbability(reflectedPath, reflectedThroughput, m_minThroughput, m_russianRoulette);
+
+                    if (survival > 0.0)
                     {
-                        i--;
-                        continue;
+                        Color reflectedColor = traceRay(scene, reflectedPath, distRay, recursion - 1, reflectionBudget, reflectedThroughput / survival);
+                        colorSum += reflectedColor * (reflectance / survival);
                     }
-                    Color reflectedColor = traceRay(distRay, recursion - 1);
-                    colorSum += reflectedColor * materialProperties.m_reflectance;
                 }
 
-                color += colorSum / m_reflectionDist;
+                color += colorSum / reflectionCount;
             }
         }
 
         //refracted ray
-        if (m_previewMode == false && materialProperties.m_transparency > 0 && recursion > 0)
+        if (refractionCount > 0)
         {
             double n2 = intersection.m_material->getProperties().m_refractionIndex;
             Ray refractedRay;
@@ -131,32 +261,60 @@ Color RayTracer::traceRay(const Ray& ray, int recursion) const
             {
                 refractedRay.shiftOrigin();
 
+                double refractedThroughput = throughput * transparency;
+
                 if (m_refractionDist == 1)
                 {
-                    Color refractedColor = traceRay(refractedRay, recursion - 1);
-                    color += refractedColor * materialProperties.m_transparency;
+                    SamplePath refractedPath = path.child(refractionDimension, 0);
+                    double survival = getSurvivalProbability(refractedPath, refractedThroughput, m_minThroughput, m_russianRoulette);
+
+                    if (survival > 0.0)
+                    {
+                        Color refractedColor = traceRay(scene, refractedPath, refractedRay, recursion - 1, refractionBudget, refractedThroughput / survival);
+                        color += refractedColor * (transparency / survival);
+                    }
                 }
                 else
                 {
                     Color colorSum;
 
-                    for (int i = 0; i < m_refractionDist; ++i)
+                    OrthonormalBasis refractionBasis(refractedRay.getDirection());
+                    double refractionRadius = Ray::getConeRadius(materialProperties.m_refractionDistAngle);
+                    Vector refractionSide = dot(refractedRay.getDirection(), normal) >= 0 ? normal : -normal;
+
+                    for (int i = 0; i < refractionCount && !m_cancellationToken.isCancelled(); ++i)
                     {
-                        Ray distRay = refractedRay.distribute(materialProperties.m_refractionDistAngle);
-                        if (dot(distRay.getDirection(), normal) < 0)
+                        double u;
+                        double v;
+                        sampler.get2D(path, refractionDimension, i, refractionCount, u, v);
+                        Ray distRay = refractedRay.distribute(refractionBasis, refractionRadius, refractionSide, u, v);
+                        SamplePath refractedPath = path.child(refractionDimension, i);
+                        double survival = getSurvivalProbability(refractedPath, refractedThroughput, m_minThroughput, m_russianRoulette);
+
+                        if (survival > 0.0)
                         {
-                            i--;
-                            continue;
+                            Color refractedColor = traceRay(scene, refractedPath, distRay, recursion - 1, refractionBudget, refractedThroughput / survival);
+                            colorSum += refractedColor * (transparency / survival);
                         }
-                        Color refractedColor = traceRay(distRay, recursion - 1);
-                        colorSum += refractedColor * materialProperties.m_transparency;
                     }
 
-                    color += colorSum / m_refractionDist;
+                    color += colorSum / refractionCount;
                 }
             }
         }
 
+        //a thread hands its statistics over once per primary ray so the shared counters are rarely touched
+        if (path.m_depth == 0)
+        {
+            flushOccluderStatistics();
+
+            if (m_rayBudgetCapped == true)
+            {
+                countCappedSamples(1);
+                m_rayBudgetCapped = false;
+            }
+        }
+
         return color;
 
     }
@@ -166,16 +324,204 @@ Color RayTracer::traceRay(const Ray& ray, int recursion) const
     }
 }
 
-Intersection RayTracer::getIntersection(const Ray& ray) const
+void RayTracer::selectLights(const LightTree& lightTree, const Sampler& sampler, const SamplePath& path, const Vector& point, const Vector& normal, 
+    const MaterialProperties& materialProperties, double threshold, int sampleCount, std::vector<LightTree::LightSample>& lights)
+{
+    lights.clear();
+
+    if (sampleCount > 0 && lightTree.getLightCount() > static_cast<size_t>(sampleCount))
+    {
+        for (int k = 0; k < sampleCount; ++k)
+        {
+            double u;
+            double v;
+            sampler.get2D(path, LIGHT_DIMENSION, k, sampleCount, u, v);
+
+            LightTree::LightSample light;
+
+            if (lightTree.sample(point, normal, u, light))
+            {
+                light.m_weight /= sampleCount;
+                lights.push_back(light);
+            }
+        }
+
+        return;
+    }
+
+    //lights below the horizon are rejected by their shadow ray direction anyway, walking the tree only pays off with a threshold
+    if (threshold <= 0.0)
+    {
+        for (size_t l = 0; l < lightTree.getLightCount(); ++l)
+        {
+            lights.push_back({ static_cast<int>(l), 1.0 });
+        }
+
+        return;
+    }
+
+    //a light adds at most its intensity times the brightest diffuse and specular channels of the material
+    const Color& diffuse = materialProperties.m_diffuse;
+    const Color& specular = materialProperties.m_specular;
+    double reflectivity = std::max(diffuse.m_red, std::max(diffuse.m_green, diffuse.m_blue)) + std::max(specular.m_red, std::max(specular.m_green, specular.m_blue));
+
+    if (threshold > 0.0 && reflectivity <= 0.0)
+    {
+        return;
+    }
+
+    lightTree.cull(point, normal, threshold > 0.0 ? threshold / reflectivity : 0.0, lights);
+}
+
+void RayTracer::getShadowSample(const Sampler& sampler, const SamplePath& path, int light, int index, int probeRayCount, int shadowRayCount, double& u, double& v)
+{
+    //the probes and the rest of the budget are stratified on their own, so the probes alone already cover the light
+    if (index < probeRayCount)
+    {
+        sampler.get2D(path, light, index, probeRayCount, u, v);
+    }
+    else
+    {
+        sampler.get2D(path, light, index, shadowRayCount - probeRayCount, u, v);
+    }
+}
+
+double RayTracer::getSurvivalProbability(const SamplePath& path, double throughput, double minThroughput, bool russianRoulette)
+{
+    if (throughput >= minThroughput)
+    {
+        return 1.0;
+    }
+
+    if (russianRoulette == false)
+    {
+        return 0.0;
+    }
+
+    //the survivors are weighted up by the inverse of the probability, so on average nothing is lost
+    double probability = throughput / minThroughput;
+
+    return Sampler::random(path, ROULETTE_DIMENSION, 0) < probability ? probability : 0.0;
+}
+
+bool RayTracer::splitRayBudget(double budget, int lightCount, int softLightCount, int& shadowRayCount, int& reflectionCount, double& reflectionBudget, 
+    int& refractionCount, double& refractionBudget)
+{
+    bool softShadows = softLightCount > 0 && shadowRayCount > 1;
+    int effects = (softShadows ? 1 : 0) + (reflectionCount > 0 ? 1 : 0) + (refractionCount > 0 ? 1 : 0);
+
+    if (effects == 0)
+    {
+        return false;
+    }
+
+    //the direct light is never cut, so a point can overspend a nearly exhausted budget by its hard shadows
+    double share = std::max(0.0, budget - 1.0 - lightCount) / effects;
+    bool capped = false;
+
+    if (softShadows)
+    {
+        double affordable = 1.0 + share / softLightCount;
+
+        if (affordable < shadowRayCount)
+        {
+            shadowRayCount = static_cast<int>(affordable);
+            capped = true;
+        }
+    }
+
+    if (reflectionCount > 0 && share < reflectionCount)
+    {
+        reflectionCount = static_cast<int>(share);
+        capped = true;
+    }
+
+    if (refractionCount > 0 && share < refractionCount)
+    {
+        refractionCount = static_cast<int>(share);
+        capped = true;
+    }
+
+    reflectionBudget = reflectionCount > 0 ? share / reflectionCount : 0.0;
+    refractionBudget = refractionCount > 0 ? share / refractionCount : 0.0;
+
+    return capped;
+}
+
+double RayTracer::getSampleRayBudget(int64_t tracedRays, int raysLeft) const
+{
+    double budget = m_rayBudget > 0 ? m_rayBudget : std::numeric_limits<double>::infinity();
+
+    if (m_tileRayBudget > 0 && raysLeft > 0)
+    {
+        budget = std::min(budget, std::max(0.0, static_cast<double>(m_tileRayBudget - tracedRays)) / raysLeft);
+    }
+
+    return budget;
+}
+
+void RayTracer::countSoftShadowRays(int64_t points, int64_t rays) const
+{
+    m_softShadowPoints.fetch_add(points, std::memory_order_relaxed);
+    m_softShadowRays.fetch_add(rays, std::memory_order_relaxed);
+}
+
+void RayTracer::countOccluderLookups(int64_t lookups, int64_t hits, int64_t occluded) const
+{
+    m_occluderLookups.fetch_add(lookups, std::memory_order_relaxed);
+    m_occluderHits.fetch_add(hits, std::memory_order_relaxed);
+    m_occludedRays.fetch_add(occluded, std::memory_order_relaxed);
+}
+
+void RayTracer::countCappedSamples(int64_t samples) const
+{
+    m_cappedSamples.fetch_add(samples, std::memory_order_relaxed);
+}
+
+void RayTracer::countWavefrontStatistics(WavefrontTracer& tracer) const
+{
+    countSoftShadowRays(tracer.getSoftShadowPoints(), tracer.getSoftShadowRays());
+    countCappedSamples(tracer.getCappedSamples());
+    flushOccluderStatistics();
+}
+
+void RayTracer::flushOccluderStatistics() const
+{
+    int64_t lookups;
+    int64_t hits;
+    int64_t occluded;
+    m_occluderCache.takeStatistics(lookups, hits, occluded);
+
+    if (lookups > 0)
+    {
+        countOccluderLookups(lookups, hits, occluded);
+    }
+}
+
+bool RayTracer::isOccluded(const CompiledScene& scene, const Ray& ray, int light) const
+{
+    m_tracedRays++;
+
+    if (m_occluderCaching == false)
+    {
+        Intersection intersection = getIntersection(scene, ray);
+        return intersection.m_t > 0 && intersection.m_t <= 1;
+    }
+
+    m_occluderCache.prepare(scene);
+
+    return m_occluderCache.isOccluded(scene, ray, light, m_cancellationToken);
+}
+
+Intersection RayTracer::getIntersection(const CompiledScene& scene, const Ray& ray) const
 {
     Intersection intersection(0.0);
 
-	std::vector<ComponentShape*> shapes = m_scene->getShapes();
-    for (const ComponentShape* shape : shapes)
+    for (const ComponentShape* shape : scene.getShapes())
     {
-        if (!shape->isEnabled())
+        if (m_cancellationToken.isCancelled())
         {
-            continue;
+            break;
         }
 
         Intersection intersection2 = shape->getIntersection(ray);
@@ -193,40 +539,95 @@ Intersection RayTracer::getIntersection(const Ray& ray) const
     return intersection;
 }
 
-double RayTracer::fresnel(const Vector& incident, const Vector& normal, double n1, double n2, bool out) const
+double RayTracer::fresnel(const Vector& incident, const Vector& normal, double n1, double n2)
 {
-    double cos1;
-    double n;
+    double cos1 = fabs(dot(normal, incident)) / (normal.length() * incident.length());
+	double sin2 = (n1 / n2) * sqrt(std::max(0.0, 1 - cos1 * cos1));
 
-    if (out)
+    if (sin2 >= 1)
     {
-        cos1 = dot(-normal, incident);
-        n = n2 / 1;
+        return 1;
     }
     else
     {
-        cos1 = dot(normal, incident);
-        n = 1 / n2;
+        double cos2 = sqrt(std::max(0.0, 1 - sin2 * sin2));
+        double Rs = ((n1 * cos1) - (n2 * cos2)) / ((n1 * cos1) + (n2 * cos2));
+        double Rp = ((n1 * cos2) - (n2 * cos1)) / ((n1 * cos2) + (n2 * cos1));
+        return (Rs * Rs + Rp * Rp) / 2;
     }
+}
+
+void RayTracer::selectFresnelBranch(const SamplePath& path, const Vector& incident, const Vector& normal, double refractionIndex, bool out,
+    double& reflectance, double& transparency)
+{
+    //the same convention as Ray::refract, leaving the shape goes from the material's index to 1
+    double reflected = out ? fresnel(incident, normal, refractionIndex, 1.0) : fresnel(incident, normal, 1.0, refractionIndex);
 
-	double sin2 = n * sqrt(std::max(0.0, 1 - cos1 * cos1));
+    double reflectionWeight = reflectance + transparency * reflected;
+    double refractionWeight = transparency * (1.0 - reflected);
+    double weight = reflectionWeight + refractionWeight;
 
-    if (sin2 >= 1)
+    if (weight <= 0.0)
     {
-        return 1;
+        return;
+    }
+
+    if (Sampler::random(path, FRESNEL_DIMENSION, 0) * weight < reflectionWeight)
+    {
+        reflectance = weight;
+        transparency = 0.0;
     }
     else
     {
-        double cos2 = sqrt(std::max(0.0, 1 - sin2 * sin2));
-        cos1 = fabs(cos1);
-        double Rs = ((n2 * cos1) - (n1 * cos2)) / ((n2 * cos1) + (n1 * cos2));
-        double Rp = ((n1 * cos1) - (n2 * cos2)) / ((n1 * cos1) + (n2 * cos2));
-        return (Rs * Rs + Rp * Rp) / 2;
+        reflectance = 0.0;
+        transparency = weight;
     }
 }
 
+void RayTracer::presentTile(const Tile& tile)
+{
+	std::lock_guard<std::mutex> lock(m_frontImageMutex);
+
+	m_frontImage.copyRegion(m_image, tile.m_x, tile.m_y, tile.m_width, tile.m_height);
+}
+
+void RayTracer::presentImage()
+{
+	std::lock_guard<std::mutex> lock(m_frontImageMutex);
+
+	m_frontImage = m_image;
+}
+
+void RayTracer::swapImages()
+{
+	std::lock_guard<std::mutex> lock(m_frontImageMutex);
+
+	std::swap(m_frontImage, m_image);
+}
+
+void RayTracer::storeReprojectionSample(int x, int y, const Ray& ray, double hitDistance, const Color& color)
+{
+	if (x < 0 || x >= m_image.getWidth() || y < 0 || y >= m_image.getHeight())
+	{
+		return;
+	}
+
+	//a miss is stored far away along the ray so it still moves with camera rotation
+	Vector point = ray.getPoint(hitDistance > 0.0 ? hitDistance : REPROJECTION_FAR);
+
+	ReprojectionSample& sample = m_reprojectionSamples[y * m_image.getWidth() + x];
+	sample.m_x = static_cast<float>(point.m_x);
+	sample.m_y = static_cast<float>(point.m_y);
+	sample.m_z = static_cast<float>(point.m_z);
+	sample.m_red = static_cast<float>(color.m_red);
+	sample.m_green = static_cast<float>(color.m_green);
+	sample.m_blue = static_cast<float>(color.m_blue);
+	sample.m_age = 0;
+}
+
 RayTracer::RayTracer(int width, int height, Scene* scene, Camera* camera)
 	: m_image(Image(width, height))
+	, m_frontImage(Image(width, height))
 	, m_scene(scene)
 	, m_camera(camera)
     , m_adaptiveSuperSampling(true)
@@ -237,7 +638,7 @@ RayTracer::RayTracer(int width, int height, Scene* scene, Camera* camera)
     , m_shadowDist(1)
     , m_reflectionDist(1)
     , m_refractionDist(1)
-    , m_stop(false)
+	, m_randomEngine(std::chrono::system_clock::now().time_since_epoch().count())
 {
     
 }
@@ -272,11 +673,21 @@ bool RayTracer::getPreviewMode() const
     return m_previewMode;
 }
 
+bool RayTracer::getPreviewShadows() const
+{
+    return m_previewShadows;
+}
+
 int RayTracer::getSubSamplingSize() const
 {
     return m_subSamplingSize;
 }
 
+int RayTracer::getPreviewSubSamplingSize() const
+{
+    return m_previewSubSamplingSize > 0 ? m_previewSubSamplingSize : m_subSamplingSize;
+}
+
 int RayTracer::getRecursion() const
 {
     return m_recursion;
@@ -297,135 +708,575 @@ int RayTracer::getRefractionDist() const
     return m_refractionDist;
 }
 
-const Image& RayTracer::getImage() const
+int RayTracer::getThreadCount() const
 {
-    return m_image;
+    return m_threadCount;
 }
 
-const unsigned char* RayTracer::getPixmap() const
+bool RayTracer::getProgressiveRefinement() const
 {
-    return m_image.getPixmap();
+	return m_progressiveRefinement;
 }
 
-std::string RayTracer::toDescription() const
+int RayTracer::getRefinementUpdateInterval() const
 {
-	std::stringstream ss;
+	return m_refinementUpdateInterval;
+}
 
-	ss << DESCRIPTION_LABEL << ","
-		<< 10 << ","
-		<< m_backgroundColor.m_red << ","
-		<< m_backgroundColor.m_green << ","
-		<< m_backgroundColor.m_blue << ","
-		<< m_adaptiveSuperSampling << ","
-		<< m_superSamplingThreshold << ","
-		<< m_subSamplingSize << ","
-		<< m_recursion << ","
-		<< m_shadowDist << ","
-		<< m_reflectionDist << ","
-		<< m_refractionDist;
+int RayTracer::getRefinementMaxSamples() const
+{
+	return m_refinementMaxSamples;
+}
 
-	return ss.str();
+double RayTracer::getRefinementNoiseThreshold() const
+{
+	return m_refinementNoiseThreshold;
 }
 
-void RayTracer::init(Scene* scene, Camera* camera)
+int RayTracer::getAccumulatedSamples() const
 {
-	m_scene = scene;
-	m_camera = camera;
+	return m_accumulatedSamples;
 }
 
-void RayTracer::set(const std::string& description)
+double RayTracer::getRefinementNoise() const
 {
-	std::vector<std::string> list = Utility::split(description, ',');
+	return m_refinementNoise;
+}
 
-	int i = 2;
+int RayTracer::getCancelLatency() const
+{
+	return m_cancelLatency;
+}
 
-	m_backgroundColor = Color(std::stod(list[i]), std::stod(list[i + 1]), std::stod(list[i + 2]));
-	i += 3;
-	m_adaptiveSuperSampling = std::stoi(list[i++]);
-	m_superSamplingThreshold = std::stod(list[i++]);
-	m_subSamplingSize = std::stoi(list[i++]);
-	m_recursion = std::stoi(list[i++]);
-	m_shadowDist = std::stoi(list[i++]);
-	m_reflectionDist = std::stoi(list[i++]);
-	m_refractionDist = std::stoi(list[i++]);
+TileScheduler::TileOrder RayTracer::getTileOrder() const
+{
+	return m_tileOrder;
 }
 
-void RayTracer::setSize(int width, int height)
+bool RayTracer::getTemporalReprojection() const
 {
-    m_image = Image(width, height);
+	return m_temporalReprojection;
 }
 
-void RayTracer::setBackgroundColor(const Color& color)
+bool RayTracer::getWavefront() const
 {
-	m_backgroundColor = color;
+	return m_wavefront;
 }
 
-void RayTracer::setAdaptiveSuperSampling(bool adaptiveSuperSampling)
+bool RayTracer::getRaySorting() const
 {
-    m_adaptiveSuperSampling = adaptiveSuperSampling;
+	return m_raySorting;
 }
 
-void RayTracer::setSuperSamplingThreshold(double threshold)
+double RayTracer::getMinThroughput() const
 {
-    m_superSamplingThreshold = threshold;
+	return m_minThroughput;
 }
 
-void RayTracer::setPreviewMode(bool subSampling)
+bool RayTracer::getRussianRoulette() const
 {
-    m_previewMode = subSampling;
+	return m_russianRoulette;
 }
 
-void RayTracer::setSubSamplingSize(int subSamplingSize)
+bool RayTracer::getOccluderCaching() const
 {
-    m_subSamplingSize = subSamplingSize;
+	return m_occluderCaching;
 }
 
-void RayTracer::setRecursion(int recursion)
+bool RayTracer::getFresnelSelection() const
 {
-    m_recursion = recursion;
+	return m_fresnelSelection;
 }
 
-void RayTracer::setShadowDist(int shadowDist)
+int RayTracer::getRayBudget() const
 {
-    m_shadowDist = shadowDist;
+	return m_rayBudget;
 }
 
-void RayTracer::setReflectionDist(int reflectionDist)
+int RayTracer::getTileRayBudget() const
 {
-    m_reflectionDist = reflectionDist;
+	return m_tileRayBudget;
 }
 
-void RayTracer::setRefractionDist(int refractionDist)
+int64_t RayTracer::getCappedSamples() const
 {
-    m_refractionDist = refractionDist;
+	return m_cappedSamples.load();
 }
 
-int RayTracer::render()
+void RayTracer::getOccluderStatistics(int64_t& lookups, int64_t& hits, int64_t& occluded) const
 {
-	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	lookups = m_occluderLookups.load();
+	hits = m_occluderHits.load();
+	occluded = m_occludedRays.load();
+}
 
-    m_stop = false;
+double RayTracer::getLightThreshold() const
+{
+	return m_lightThreshold;
+}
+
+int RayTracer::getLightSampleCount() const
+{
+	return m_lightSampleCount;
+}
+
+bool RayTracer::getAdaptiveShadows() const
+{
+	return m_adaptiveShadows;
+}
+
+double RayTracer::getAverageShadowRays() const
+{
+	int64_t points = m_softShadowPoints.load();
+
+	return points > 0 ? m_softShadowRays.load() / static_cast<double>(points) : 0.0;
+}
+
+Sampler::SamplerType RayTracer::getSamplerType() const
+{
+	return m_samplerType;
+}
+
+RenderListener* RayTracer::getRenderListener() const
+{
+	return m_renderListener;
+}
+
+void RayTracer::readFrontImage(const std::function<void(const Image&)>& reader) const
+{
+	std::lock_guard<std::mutex> lock(m_frontImageMutex);
+
+	reader(m_frontImage);
+}
+
+std::string RayTracer::toDescription() const
+{
+	std::stringstream ss;
+
+	ss << DESCRIPTION_LABEL << ","
+		<< 22 << ","
+		<< m_backgroundColor.m_red << ","
+		<< m_backgroundColor.m_green << ","
+		<< m_backgroundColor.m_blue << ","
+		<< m_adaptiveSuperSampling << ","
+		<< m_superSamplingThreshold << ","
+		<< m_subSamplingSize << ","
+		<< m_recursion << ","
+		<< m_shadowDist << ","
+		<< m_reflectionDist << ","
+		<< m_refractionDist << ","
+		<< m_minThroughput << ","
+		<< m_russianRoulette << ","
+		<< m_lightThreshold << ","
+		<< m_lightSampleCount << ","
+		<< m_rayBudget << ","
+		<< m_tileRayBudget << ","
+		<< static_cast<int>(m_samplerType) << ","
+		<< m_wavefront << ","
+		<< m_raySorting << ","
+		<< m_adaptiveShadows << ","
+		<< m_occluderCaching << ","
+		<< m_fresnelSelection;
+
+	return ss.str();
+}
+
+void RayTracer::init(Scene* scene, Camera* camera)
+{
+	m_scene = scene;
+	m_camera = camera;
+}
+
+void RayTracer::setRenderListener(RenderListener* renderListener)
+{
+	m_renderListener = renderListener;
+}
+
+void RayTracer::set(const std::string& description)
+{
+	std::vector<std::string> list = Utility::split(description, ',');
+
+	int fieldCount = std::stoi(list[1]);
+	int i = 2;
+
+	m_backgroundColor = Color(std::stod(list[i]), std::stod(list[i + 1]), std::stod(list[i + 2]));
+	i += 3;
+	m_adaptiveSuperSampling = std::stoi(list[i++]);
+	m_superSamplingThreshold = std::stod(list[i++]);
+	m_subSamplingSize = std::stoi(list[i++]);
+	m_recursion = std::stoi(list[i++]);
+	m_shadowDist = std::stoi(list[i++]);
+	m_reflectionDist = std::stoi(list[i++]);
+	m_refractionDist = std::stoi(list[i++]);
+
+	//descriptions written before a field existed leave it unchanged
+	if (fieldCount >= 12)
+	{
+		m_minThroughput = std::stod(list[i++]);
+		m_russianRoulette = std::stoi(list[i++]);
+	}
+
+	if (fieldCount >= 14)
+	{
+		m_lightThreshold = std::stod(list[i++]);
+		m_lightSampleCount = std::stoi(list[i++]);
+	}
+
+	if (fieldCount >= 16)
+	{
+		m_rayBudget = std::stoi(list[i++]);
+		m_tileRayBudget = std::stoi(list[i++]);
+	}
+
+	if (fieldCount >= 22)
+	{
+		m_samplerType = static_cast<Sampler::SamplerType>(std::stoi(list[i++]));
+		m_wavefront = std::stoi(list[i++]);
+		m_raySorting = std::stoi(list[i++]);
+		m_adaptiveShadows = std::stoi(list[i++]);
+		m_occluderCaching = std::stoi(list[i++]);
+		m_fresnelSelection = std::stoi(list[i++]);
+	}
+}
+
+void RayTracer::setSize(int width, int height)
+{
+    m_image = Image(width, height);
+
+    invalidateReprojection();
+
+    {
+        std::lock_guard<std::mutex> lock(m_frontImageMutex);
+        m_frontImage = Image(width, height);
+    }
+
+    resetAccumulation();
+}
+
+void RayTracer::setBackgroundColor(const Color& color)
+{
+	m_backgroundColor = color;
+}
+
+void RayTracer::setAdaptiveSuperSampling(bool adaptiveSuperSampling)
+{
+    m_adaptiveSuperSampling = adaptiveSuperSampling;
+}
+
+void RayTracer::setSuperSamplingThreshold(double threshold)
+{
+    m_superSamplingThreshold = threshold;
+}
+
+void RayTracer::setPreviewMode(bool subSampling)
+{
+    m_previewMode = subSampling;
+}
+
+void RayTracer::setPreviewShadows(bool previewShadows)
+{
+    m_previewShadows = previewShadows;
+}
+
+void RayTracer::setSubSamplingSize(int subSamplingSize)
+{
+    m_subSamplingSize = subSamplingSize;
+}
+
+void RayTracer::setPreviewSubSamplingSize(int subSamplingSize)
+{
+    m_previewSubSamplingSize = subSamplingSize;
+}
 
+void RayTracer::setRecursion(int recursion)
+{
+    m_recursion = recursion;
+}
+
+void RayTracer::setShadowDist(int shadowDist)
+{
+    m_shadowDist = shadowDist;
+}
+
+void RayTracer::setReflectionDist(int reflectionDist)
+{
+    m_reflectionDist = reflectionDist;
+}
+
+void RayTracer::setRefractionDist(int refractionDist)
+{
+    m_refractionDist = refractionDist;
+}
+
+void RayTracer::setThreadCount(int threadCount)
+{
+    m_threadCount = std::max(1, threadCount);
+}
+
+void RayTracer::setProgressiveRefinement(bool progressiveRefinement)
+{
+	m_progressiveRefinement = progressiveRefinement;
+}
+
+void RayTracer::setRefinementUpdateInterval(int passes)
+{
+	m_refinementUpdateInterval = std::max(1, passes);
+}
+
+void RayTracer::setRefinementMaxSamples(int samples)
+{
+	m_refinementMaxSamples = samples;
+}
+
+void RayTracer::setRefinementNoiseThreshold(double threshold)
+{
+	m_refinementNoiseThreshold = threshold;
+}
+
+void RayTracer::setTileOrder(TileScheduler::TileOrder tileOrder)
+{
+	m_tileOrder = tileOrder;
+}
+
+void RayTracer::setRegionOfInterest(int x, int y)
+{
+	m_regionOfInterestX = x;
+	m_regionOfInterestY = y;
+}
+
+void RayTracer::setTemporalReprojection(bool temporalReprojection)
+{
+	m_temporalReprojection = temporalReprojection;
+}
+
+void RayTracer::setWavefront(bool wavefront)
+{
+	m_wavefront = wavefront;
+}
+
+void RayTracer::setRaySorting(bool raySorting)
+{
+	m_raySorting = raySorting;
+}
+
+void RayTracer::setMinThroughput(double minThroughput)
+{
+	m_minThroughput = minThroughput;
+}
+
+void RayTracer::setRussianRoulette(bool russianRoulette)
+{
+	m_russianRoulette = russianRoulette;
+}
+
+void RayTracer::setOccluderCaching(bool occluderCaching)
+{
+	m_occluderCaching = occluderCaching;
+}
+
+void RayTracer::setFresnelSelection(bool fresnelSelection)
+{
+	m_fresnelSelection = fresnelSelection;
+}
+
+void RayTracer::setRayBudget(int rayBudget)
+{
+	m_rayBudget = rayBudget;
+}
+
+void RayTracer::setTileRayBudget(int tileRayBudget)
+{
+	m_tileRayBudget = tileRayBudget;
+}
+
+void RayTracer::setLightThreshold(double threshold)
+{
+	m_lightThreshold = threshold;
+}
+
+void RayTracer::setLightSampleCount(int sampleCount)
+{
+	m_lightSampleCount = sampleCount;
+}
+
+void RayTracer::setAdaptiveShadows(bool adaptiveShadows)
+{
+	m_adaptiveShadows = adaptiveShadows;
+}
+
+void RayTracer::setSamplerType(Sampler::SamplerType samplerType)
+{
+	m_samplerType = samplerType;
+}
+
+void RayTracer::invalidateReprojection()
+{
+	m_reprojectionSamples.clear();
+	m_reprojectedSamples.clear();
+}
+
+int RayTracer::render()
+{
+    //the render threads only read the compiled scene
+    CompiledScene scene(*m_scene);
+
+    return render(scene);
+}
+
+int RayTracer::render(const CompiledScene& scene)
+{
     int width = m_image.getWidth();
     int height = m_image.getHeight();
 
+    //settings can change while rendering, so the flag is read only once
+    bool temporalReprojection = m_temporalReprojection;
+
+    if (m_previewMode == true && temporalReprojection == true && m_reprojectionSamples.size() == static_cast<size_t>(width * height))
+    {
+        return renderReprojection(scene);
+    }
+
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+    m_cancelLatency = 0;
+    m_softShadowPoints = 0;
+    m_softShadowRays = 0;
+    m_occluderLookups = 0;
+    m_occluderHits = 0;
+    m_occludedRays = 0;
+    m_cappedSamples = 0;
+
+    resetAccumulation();
+
+    if (temporalReprojection == true)
+    {
+        m_reprojectionSamples.assign(width * height, ReprojectionSample());
+    }
+    else
+    {
+        m_reprojectionSamples.clear();
+    }
+
     int stepSize = 1;
     if (m_previewMode)
     {
-        stepSize = m_subSamplingSize;
+        stepSize = getPreviewSubSamplingSize();
     }
 
-    for (int y = 0; y < height; y += stepSize)
+    //tiles are a whole number of preview blocks so a block never spans two tiles
+    int tileSize = stepSize * std::max(4, TILE_SIZE / stepSize);
+    std::vector<Tile> tiles = TileScheduler::createTiles(width, height, tileSize, m_tileOrder, m_regionOfInterestX, m_regionOfInterestY);
+
+    //threads take the next tile in priority order, so the important tiles are still finished first
+    std::atomic<size_t> nextTile(0);
+
+    auto renderTiles = [&]()
     {
-        for (int x = 0; x < width; x += stepSize)
+        for (size_t t = nextTile++; t < tiles.size(); t = nextTile++)
         {
-            if (m_stop)
+            if (!renderTile(scene, tiles[t], stepSize, temporalReprojection))
             {
-				std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+                return;
+            }
 
-				std::chrono::duration<int64_t, std::micro> elapsed = std::chrono::duration_cast<std::chrono::duration<int64_t, std::micro>>(t2 - t1);
+            //a preview is shown only once it is complete, a final render replaces it one finished tile at a time
+            if (m_previewMode == false)
+            {
+                presentTile(tiles[t]);
 
-				return elapsed.count();
+                if (m_renderListener != nullptr)
+                {
+                    m_renderListener->onTileFinished(tiles[t]);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < std::min<int>(m_threadCount, static_cast<int>(tiles.size())); ++i)
+    {
+        threads.emplace_back(renderTiles);
+    }
+
+    renderTiles();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (m_previewMode == true && !m_cancellationToken.isCancelled())
+    {
+        swapImages();
+    }
+
+	m_cancelLatency = m_cancellationToken.getMicrosecondsSinceCancel();
+
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	std::chrono::duration<int64_t, std::micro> elapsed = std::chrono::duration_cast<std::chrono::duration<int64_t, std::micro>>(t2 - t1);
+
+	return elapsed.count();
+}
+
+bool RayTracer::renderRegion(const CompiledScene& scene, const Tile& tile, std::vector<Color>& pixels)
+{
+    if (!renderTile(scene, tile, 1, false))
+    {
+        return false;
+    }
+
+    pixels.clear();
+    pixels.reserve(tile.m_width * tile.m_height);
+
+    for (int y = tile.m_y; y < tile.m_y + tile.m_height; ++y)
+    {
+        for (int x = tile.m_x; x < tile.m_x + tile.m_width; ++x)
+        {
+            pixels.push_back(m_image.getPixel(x, y));
+        }
+    }
+
+    return true;
+}
+
+bool RayTracer::renderTile(const CompiledScene& scene, const Tile& tile, int stepSize, bool temporalReprojection)
+{
+    if (m_wavefront == true)
+    {
+        return renderTileWavefront(scene, tile, stepSize, temporalReprojection);
+    }
+
+    int width = m_image.getWidth();
+    int height = m_image.getHeight();
+
+    //the primary rays and the supersampling rays of the tile are paid from one pool, 
+    //so every ray gets a share of what the rays before it left over
+    int columns = (tile.m_width + stepSize - 1) / stepSize;
+    int rows = (tile.m_height + stepSize - 1) / stepSize;
+    int raysLeft = columns * rows;
+    m_tracedRays = 0;
+
+    //the left or top neighbour of a pixel on the first row or column of the tile belongs to another tile that may not be rendered yet, 
+    //such pixels are compared against their neighbour on the right or below once the rest of the tile is done
+    struct BorderSample
+    {
+        int m_x;
+        int m_y;
+        Ray m_ray;
+        double m_hitDistance;
+    };
+
+    bool superSampling = m_previewMode == false && m_adaptiveSuperSampling == true;
+    std::vector<BorderSample> borderSamples;
+
+    for (int y = tile.m_y; y < tile.m_y + tile.m_height; y += stepSize)
+    {
+        for (int x = tile.m_x; x < tile.m_x + tile.m_width; x += stepSize)
+        {
+            if (m_cancellationToken.isCancelled())
+            {
+                return false;
             }
 
             double xx = x + 0.5 * stepSize;
@@ -433,37 +1284,34 @@ int RayTracer::render()
             double yy = y + 0.5 * stepSize;
             if (yy >= height) yy = y + (0.5 * (height - y));
             Ray ray = m_camera->getRay(width, height, xx, yy);
-            Color color = traceRay(ray, m_recursion);
+            double hitDistance = 0.0;
+            Color color = traceRay(scene, SamplePath{ x, y, 0 }, ray, m_recursion, getSampleRayBudget(m_tracedRays, raysLeft--), 1.0, &hitDistance);
+            Ray primaryRay = ray;
+
+            //supersampling is only enabled for final renders, which never subsample
+            if (superSampling == true && (x == tile.m_x || y == tile.m_y))
+            {
+                m_image.putPixel(x, y, color);
+                borderSamples.push_back({ x, y, primaryRay, hitDistance });
+                continue;
+            }
 
-            if (m_previewMode == false && m_adaptiveSuperSampling == true && x > 0 && y > 0)
+            if (superSampling == true)
             {
                 const Color& leftColor = m_image.getPixel(x - 1, y);
 				const Color& topColor = m_image.getPixel(x, y - 1);
 
                 if (distance(color, leftColor) > m_superSamplingThreshold || distance(color, topColor) > m_superSamplingThreshold)
                 {
-                    Color color2;
-
-                    ray = m_camera->getRay(width, height, x - 0.25, y + 0.25);
-                    color2 = traceRay(ray, m_recursion);
-                    color.accumulate(color2, 0.6);
-
-                    ray = m_camera->getRay(width, height, x + 0.25, y + 0.25);
-                    color2 = traceRay(ray, m_recursion);
-                    color.accumulate(color2, 0.6);
-
-                    ray = m_camera->getRay(width, height, x - 0.25, y - 0.25);
-                    color2 = traceRay(ray, m_recursion);
-                    color.accumulate(color2, 0.6);
-
-                    ray = m_camera->getRay(width, height, x + 0.25, y - 0.25);
-                    color2 = traceRay(ray, m_recursion);
-                    color.accumulate(color2, 0.6);
-
-                    color /= 1 + 4*0.6;
+                    superSample(scene, x, y, raysLeft, color);
                 }
             }
 
+            if (temporalReprojection == true)
+            {
+                storeReprojectionSample(static_cast<int>(xx), static_cast<int>(yy), primaryRay, hitDistance, color);
+            }
+
             for (int yy = y; yy < y + stepSize; ++yy)
             {
                 if (yy >= height) break;
@@ -475,16 +1323,505 @@ int RayTracer::render()
                     m_image.putPixel(xx, yy, color);
                 }
             }
+        }
+    }
+
+    for (size_t b = 0; b < borderSamples.size(); ++b)
+    {
+        if (m_cancellationToken.isCancelled())
+        {
+            return false;
+        }
+
+        const BorderSample& sample = borderSamples[b];
+        int x = sample.m_x;
+        int y = sample.m_y;
+        Color color = m_image.getPixel(x, y);
+
+        //a tile only one pixel wide or high has no neighbour to compare against in that direction
+        int horizontalX = x > tile.m_x ? x - 1 : x + 1;
+        int verticalY = y > tile.m_y ? y - 1 : y + 1;
+        bool horizontalEdge = horizontalX < tile.m_x + tile.m_width && distance(color, m_image.getPixel(horizontalX, y)) > m_superSamplingThreshold;
+        bool verticalEdge = verticalY < tile.m_y + tile.m_height && distance(color, m_image.getPixel(x, verticalY)) > m_superSamplingThreshold;
+
+        if (horizontalEdge || verticalEdge)
+        {
+            //the border pixels still waiting may need their supersampling rays as well
+            superSample(scene, x, y, 4 * static_cast<int>(borderSamples.size() - b - 1), color);
+            m_image.putPixel(x, y, color);
+        }
+
+        if (temporalReprojection == true)
+        {
+            storeReprojectionSample(x, y, sample.m_ray, sample.m_hitDistance, color);
+        }
+    }
+
+    return true;
+}
 
-            if (y + stepSize < height)
+void RayTracer::superSample(const CompiledScene& scene, int x, int y, int raysLeft, Color& color) const
+{
+    //a tile that has spent its budget cannot afford the supersampling rays themselves
+    if (getSampleRayBudget(m_tracedRays, raysLeft + 4) < 1.0)
+    {
+        return;
+    }
+
+    int width = m_image.getWidth();
+    int height = m_image.getHeight();
+
+    Color color2;
+
+    Ray ray = m_camera->getRay(width, height, x - 0.25, y + 0.25);
+    color2 = traceRay(scene, SamplePath{ x, y, 1 }, ray, m_recursion, getSampleRayBudget(m_tracedRays, raysLeft + 4));
+    color.accumulate(color2, 0.6);
+
+    ray = m_camera->getRay(width, height, x + 0.25, y + 0.25);
+    color2 = traceRay(scene, SamplePath{ x, y, 2 }, ray, m_recursion, getSampleRayBudget(m_tracedRays, raysLeft + 3));
+    color.accumulate(color2, 0.6);
+
+    ray = m_camera->getRay(width, height, x - 0.25, y - 0.25);
+    color2 = traceRay(scene, SamplePath{ x, y, 3 }, ray, m_recursion, getSampleRayBudget(m_tracedRays, raysLeft + 2));
+    color.accumulate(color2, 0.6);
+
+    ray = m_camera->getRay(width, height, x + 0.25, y - 0.25);
+    color2 = traceRay(scene, SamplePath{ x, y, 4 }, ray, m_recursion, getSampleRayBudget(m_tracedRays, raysLeft + 1));
+    color.accumulate(color2, 0.6);
+
+    color /= 1 + 4*0.6;
+}
+
+bool RayTracer::renderTileWavefront(const CompiledScene& scene, const Tile& tile, int stepSize, bool temporalReprojection)
+{
+    int width = m_image.getWidth();
+    int height = m_image.getHeight();
+
+    int columns = (tile.m_width + stepSize - 1) / stepSize;
+    int rows = (tile.m_height + stepSize - 1) / stepSize;
+
+    std::vector<Ray> rays;
+    std::vector<SamplePath> paths;
+    rays.reserve(columns * rows);
+    paths.reserve(columns * rows);
+
+    for (int y = tile.m_y; y < tile.m_y + tile.m_height; y += stepSize)
+    {
+        for (int x = tile.m_x; x < tile.m_x + tile.m_width; x += stepSize)
+        {
+            double xx = x + 0.5 * stepSize;
+            if (xx >= width) xx = x + (0.5 * (width - x));
+            double yy = y + 0.5 * stepSize;
+            if (yy >= height) yy = y + (0.5 * (height - y));
+            rays.push_back(m_camera->getRay(width, height, xx, yy));
+            paths.push_back(SamplePath{ x, y, 0 });
+        }
+    }
+
+    WavefrontTracer tracer(*this, scene, m_cancellationToken, m_occluderCache);
+    std::vector<Color> colors;
+    std::vector<double> hitDistances;
+
+    //the supersampling batch is paid from what the primary rays left of the tile budget
+    bool traced = tracer.trace(rays, paths, m_recursion, getSampleRayBudget(0, columns * rows), colors, &hitDistances);
+    int64_t tracedRays = tracer.getTracedRays();
+    countWavefrontStatistics(tracer);
+
+    if (!traced)
+    {
+        return false;
+    }
+
+    if (m_previewMode == false && m_adaptiveSuperSampling == true)
+    {
+        //the neighbours are compared before any of them is supersampled, so all extra rays go into one more batch
+        std::vector<int> superSampled;
+        std::vector<Ray> superRays;
+        std::vector<SamplePath> superPaths;
+
+        for (int row = 0; row < rows; ++row)
+        {
+            for (int column = 0; column < columns; ++column)
+            {
+                int i = row * columns + column;
+
+                //pixels on the first row or column of the tile compare against their neighbour on the right or below instead, 
+                //a tile only one pixel wide or high has no neighbour in that direction
+                int horizontal = column > 0 ? i - 1 : i + 1;
+                int vertical = row > 0 ? i - columns : i + columns;
+                bool horizontalEdge = columns > 1 && distance(colors[i], colors[horizontal]) > m_superSamplingThreshold;
+                bool verticalEdge = rows > 1 && distance(colors[i], colors[vertical]) > m_superSamplingThreshold;
+
+                if (horizontalEdge || verticalEdge)
+                {
+                    int x = tile.m_x + column;
+                    int y = tile.m_y + row;
+
+                    superSampled.push_back(i);
+                    superRays.push_back(m_camera->getRay(width, height, x - 0.25, y + 0.25));
+                    superRays.push_back(m_camera->getRay(width, height, x + 0.25, y + 0.25));
+                    superRays.push_back(m_camera->getRay(width, height, x - 0.25, y - 0.25));
+                    superRays.push_back(m_camera->getRay(width, height, x + 0.25, y - 0.25));
+
+                    for (int pass = 1; pass <= 4; ++pass)
+                    {
+                        superPaths.push_back(SamplePath{ x, y, pass });
+                    }
+                }
+            }
+        }
+
+        std::vector<Color> superColors;
+        double superBudget = getSampleRayBudget(tracedRays, static_cast<int>(superRays.size()));
+
+        if (superBudget < 1.0)
+        {
+            superSampled.clear();
+            superRays.clear();
+        }
+
+        if (!superRays.empty())
+        {
+            traced = tracer.trace(superRays, superPaths, m_recursion, superBudget, superColors);
+            countWavefrontStatistics(tracer);
+
+            if (!traced)
             {
-                m_image.putPixel(x, y + stepSize, Color(1, 0, 0));
+                return false;
             }
         }
 
-        emit lineFinished();
+        for (size_t s = 0; s < superSampled.size(); ++s)
+        {
+            Color& color = colors[superSampled[s]];
+
+            for (int j = 0; j < 4; ++j)
+            {
+                color.accumulate(superColors[s * 4 + j], 0.6);
+            }
+
+            color /= 1 + 4*0.6;
+        }
     }
 
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            int i = row * columns + column;
+            int x = tile.m_x + column * stepSize;
+            int y = tile.m_y + row * stepSize;
+
+            if (temporalReprojection == true)
+            {
+                int xx = static_cast<int>(x + 0.5 * stepSize >= width ? x + 0.5 * (width - x) : x + 0.5 * stepSize);
+                int yy = static_cast<int>(y + 0.5 * stepSize >= height ? y + 0.5 * (height - y) : y + 0.5 * stepSize);
+                storeReprojectionSample(xx, yy, rays[i], hitDistances[i], colors[i]);
+            }
+
+            for (int yy = y; yy < std::min(y + stepSize, height); ++yy)
+            {
+                for (int xx = x; xx < std::min(x + stepSize, width); ++xx)
+                {
+                    m_image.putPixel(xx, yy, colors[i]);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+int RayTracer::renderReprojection(const CompiledScene& scene)
+{
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+	m_cancelLatency = 0;
+	m_softShadowPoints = 0;
+	m_softShadowRays = 0;
+	m_occluderLookups = 0;
+	m_occluderHits = 0;
+	m_occludedRays = 0;
+	m_cappedSamples = 0;
+
+	resetAccumulation();
+
+	int width = m_image.getWidth();
+	int height = m_image.getHeight();
+	int stepSize = std::max(1, getPreviewSubSamplingSize());
+
+	const Vector& position = m_camera->getPosition();
+	const Vector& direction = m_camera->getDirection();
+
+	//move every sample of the previous frame to the pixel it lands on in the current view, the nearest one wins
+	m_reprojectedSamples.assign(width * height, ReprojectionSample());
+
+	for (int i = 0; i < width * height; ++i)
+	{
+		if (i % width == 0 && m_cancellationToken.isCancelled())
+		{
+			m_cancelLatency = m_cancellationToken.getMicrosecondsSinceCancel();
+
+			std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+			std::chrono::duration<int64_t, std::micro> elapsed = std::chrono::duration_cast<std::chrono::duration<int64_t, std::micro>>(t2 - t1);
+
+			return elapsed.count();
+		}
+
+		const ReprojectionSample& sample = m_reprojectionSamples[i];
+
+		if (sample.m_age < 0 || sample.m_age >= REPROJECTION_MAX_AGE)
+		{
+			continue;
+		}
+
+		Vector point(sample.m_x, sample.m_y, sample.m_z);
+		double px;
+		double py;
+
+		if (!m_camera->project(width, height, point, px, py) || px < 0 || py < 0 || px >= width || py >= height)
+		{
+			continue;
+		}
+
+		float depth = static_cast<float>(dot(point - position, direction));
+
+		ReprojectionSample& target = m_reprojectedSamples[static_cast<int>(py) * width + static_cast<int>(px)];
+
+		if (target.m_age < 0 || depth < target.m_depth)
+		{
+			target = sample;
+			target.m_depth = depth;
+			target.m_age = sample.m_age + 1;
+		}
+	}
+
+	//one ray per block refreshes a pixel whose position within the block changes every frame, 
+	//pixels that did not get a sample (disoccluded or too old) are filled with the color of their block
+	int blockSize = stepSize * stepSize;
+	m_reprojectionFrame = (m_reprojectionFrame + 1) % blockSize;
+	int offset = static_cast<int>((static_cast<int64_t>(m_reprojectionFrame) * 7919) % blockSize);
+	int offsetX = offset % stepSize;
+	int offsetY = offset / stepSize;
+
+	std::swap(m_reprojectionSamples, m_reprojectedSamples);
+
+	int tileColumns = (TILE_SIZE + stepSize - 1) / stepSize;
+	double budget = getSampleRayBudget(0, tileColumns * tileColumns);
+
+	for (int y = 0; y < height; y += stepSize)
+	{
+		for (int x = 0; x < width; x += stepSize)
+		{
+			if (m_cancellationToken.isCancelled())
+			{
+				//the previous frame is still complete, the partially built one is dropped
+				std::swap(m_reprojectionSamples, m_reprojectedSamples);
+
+				m_cancelLatency = m_cancellationToken.getMicrosecondsSinceCancel();
+
+				std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+				std::chrono::duration<int64_t, std::micro> elapsed = std::chrono::duration_cast<std::chrono::duration<int64_t, std::micro>>(t2 - t1);
+
+				return elapsed.count();
+			}
+
+			int sampleX = std::min(x + offsetX, width - 1);
+			int sampleY = std::min(y + offsetY, height - 1);
+
+			Ray ray = m_camera->getRay(width, height, sampleX + 0.5, sampleY + 0.5);
+			double hitDistance = 0.0;
+			Color color = traceRay(scene, SamplePath{ sampleX, sampleY, m_reprojectionFrame }, ray, m_recursion, budget, 1.0, &hitDistance);
+
+			storeReprojectionSample(sampleX, sampleY, ray, hitDistance, color);
+
+			for (int yy = y; yy < std::min(y + stepSize, height); ++yy)
+			{
+				for (int xx = x; xx < std::min(x + stepSize, width); ++xx)
+				{
+					const ReprojectionSample& sample = m_reprojectionSamples[yy * width + xx];
+
+					if (sample.m_age >= 0)
+					{
+						m_image.putPixel(xx, yy, Color(sample.m_red, sample.m_green, sample.m_blue));
+					}
+					else
+					{
+						m_image.putPixel(xx, yy, color);
+					}
+				}
+			}
+		}
+	}
+
+	swapImages();
+
+	m_cancelLatency = m_cancellationToken.getMicrosecondsSinceCancel();
+
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	std::chrono::duration<int64_t, std::micro> elapsed = std::chrono::duration_cast<std::chrono::duration<int64_t, std::micro>>(t2 - t1);
+
+	return elapsed.count();
+}
+
+int RayTracer::refine()
+{
+	CompiledScene scene(*m_scene);
+
+	return refine(scene);
+}
+
+int RayTracer::refine(const CompiledScene& scene)
+{
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+	m_cancelLatency = 0;
+	m_softShadowPoints = 0;
+	m_softShadowRays = 0;
+	m_occluderLookups = 0;
+	m_occluderHits = 0;
+	m_occludedRays = 0;
+	m_cappedSamples = 0;
+
+	int width = m_image.getWidth();
+	int height = m_image.getHeight();
+	int pixelCount = width * height;
+
+	//the finished image is the first sample of every pixel
+	if (m_accumulatedSamples == 0)
+	{
+		m_sampleSum.resize(pixelCount);
+		m_sampleSquareSum.resize(pixelCount);
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				const Color& color = m_image.getPixel(x, y);
+				m_sampleSum[y * width + x] = color;
+				m_sampleSquareSum[y * width + x] = color * color;
+			}
+		}
+
+		m_accumulatedSamples = 1;
+	}
+
+	const int strataCount = REFINEMENT_STRATA * REFINEMENT_STRATA;
+	const double budget = getSampleRayBudget(0, TILE_SIZE * TILE_SIZE);
+	const int threadCount = std::max(1, std::min(m_threadCount, height));
+
+	while (m_accumulatedSamples < m_refinementMaxSamples)
+	{
+		int pass = m_accumulatedSamples - 1;
+		int samples = m_accumulatedSamples + 1;
+
+		//threads take interleaved rows, each with its own engine and partial noise sum
+		std::vector<double> varianceSums(threadCount, 0.0);
+		std::vector<std::default_random_engine::result_type> seeds(threadCount);
+		for (auto& seed : seeds)
+		{
+			seed = m_randomEngine();
+		}
+
+		auto refineRows = [&](int threadIndex)
+		{
+			std::default_random_engine randomEngine(seeds[threadIndex]);
+			std::uniform_real_distribution<double> jitter(0.0, 1.0);
+			double localVarianceSum = 0.0;
+
+			for (int y = threadIndex; y < height; y += threadCount)
+			{
+				for (int x = 0; x < width; ++x)
+				{
+					if (m_cancellationToken.isCancelled())
+					{
+						return;
+					}
+
+					//every pixel visits all strata of its footprint before any stratum repeats, 
+					//the per pixel offset keeps neighbouring pixels from sampling the same stratum
+					int stratum = (pass * 7 + x * 5 + y * 3) % strataCount;
+					double sx = ((stratum % REFINEMENT_STRATA) + jitter(randomEngine)) / REFINEMENT_STRATA;
+					double sy = ((stratum / REFINEMENT_STRATA) + jitter(randomEngine)) / REFINEMENT_STRATA;
+
+					Ray ray = m_camera->getRay(width, height, x + sx, y + sy);
+					//passes 0 to 4 were taken by the render and its supersamples
+					Color color = traceRay(scene, SamplePath{ x, y, 4 + samples }, ray, m_recursion, budget);
+
+					int i = y * width + x;
+					m_sampleSum[i] += color;
+					m_sampleSquareSum[i] += color * color;
+
+					Color mean = m_sampleSum[i] / samples;
+					Color variance = m_sampleSquareSum[i] / samples - mean * mean;
+					localVarianceSum += std::max(0.0, (variance.m_red + variance.m_green + variance.m_blue) / 3.0) / samples;
+
+					m_image.putPixel(x, y, mean);
+				}
+			}
+
+			varianceSums[threadIndex] = localVarianceSum;
+		};
+
+		std::vector<std::thread> threads;
+		for (int i = 1; i < threadCount; ++i)
+		{
+			threads.emplace_back(refineRows, i);
+		}
+
+		refineRows(0);
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		if (m_cancellationToken.isCancelled())
+		{
+			//a partial pass would leave the pixels with different sample counts
+			resetAccumulation();
+
+			m_cancelLatency = m_cancellationToken.getMicrosecondsSinceCancel();
+
+			std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+			std::chrono::duration<int64_t, std::micro> elapsed = std::chrono::duration_cast<std::chrono::duration<int64_t, std::micro>>(t2 - t1);
+
+			return elapsed.count();
+		}
+
+		double varianceSum = 0.0;
+		for (double partialSum : varianceSums)
+		{
+			varianceSum += partialSum;
+		}
+
+		m_accumulatedSamples = samples;
+		m_refinementNoise = sqrt(varianceSum / std::max(1, pixelCount));
+
+		bool converged = m_refinementNoise < m_refinementNoiseThreshold || m_accumulatedSamples >= m_refinementMaxSamples;
+
+		if (converged || (m_accumulatedSamples - 1) % m_refinementUpdateInterval == 0)
+		{
+			presentImage();
+
+			if (m_renderListener != nullptr)
+			{
+				m_renderListener->onRefinementUpdated(m_accumulatedSamples, m_refinementNoise);
+			}
+		}
+
+		if (converged)
+		{
+			break;
+		}
+	}
+
+	m_cancelLatency = m_cancellationToken.getMicrosecondsSinceCancel();
+
 	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
 
 	std::chrono::duration<int64_t, std::micro> elapsed = std::chrono::duration_cast<std::chrono::duration<int64_t, std::micro>>(t2 - t1);
@@ -492,7 +1829,20 @@ int RayTracer::render()
 	return elapsed.count();
 }
 
+void RayTracer::resetAccumulation()
+{
+	m_accumulatedSamples = 0;
+	m_refinementNoise = 0.0;
+	m_sampleSum.clear();
+	m_sampleSquareSum.clear();
+}
+
 void RayTracer::cancelRendering()
 {
-    m_stop = true;
+    m_cancellationToken.cancel();
+}
+
+void RayTracer::resetCancellation()
+{
+    m_cancellationToken.reset();
 }
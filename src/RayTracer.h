@@ -1,47 +1,202 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
 #include <vector>
 
-#include <QObject>
-
 #include "Image.h"
 #include "Scene.h"
 #include "Vector.h"
 #include "Color.h"
 #include "Camera.h"
+#include "CancellationToken.h"
+#include "CompiledScene.h"
+#include "OccluderCache.h"
+#include "RenderListener.h"
+#include "Sampler.h"
+#include "TileScheduler.h"
 #include "EntityDescriptionInterface.h"
 
-class RayTracer : public QObject, public EntityDescriptionInterface
+class WavefrontTracer;
+
+class RayTracer : public EntityDescriptionInterface
 {
-    Q_OBJECT
 
 private:
 
 	Scene* m_scene = nullptr;
 	Camera* m_camera = nullptr;
+	RenderListener* m_renderListener = nullptr;
 
     bool m_previewMode = false;
+    bool m_previewShadows = true;
 	Color m_backgroundColor;
     bool m_adaptiveSuperSampling = true;
     double m_superSamplingThreshold = 0.1;
     int m_subSamplingSize = 20;
+    int m_previewSubSamplingSize = 0;
     int m_recursion = 5;
     int m_shadowDist = 1;
     int m_reflectionDist = 1;
     int m_refractionDist = 1;
-    bool m_stop = false;
+    int m_threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    CancellationToken m_cancellationToken;
+    int m_cancelLatency = 0;
+    TileScheduler::TileOrder m_tileOrder = TileScheduler::TileOrder::SPIRAL;
+    std::atomic<int> m_regionOfInterestX{ -1 };
+    std::atomic<int> m_regionOfInterestY{ -1 };
     Image m_image;
+    Image m_frontImage;
+    mutable std::mutex m_frontImageMutex;
+
+	bool m_progressiveRefinement = true;
+	int m_refinementUpdateInterval = 4;
+	int m_refinementMaxSamples = 256;
+	double m_refinementNoiseThreshold = 0.002;
+	int m_accumulatedSamples = 0;
+	double m_refinementNoise = 0.0;
+	std::vector<Color> m_sampleSum;
+	std::vector<Color> m_sampleSquareSum;
+	std::default_random_engine m_randomEngine;
+
+	static constexpr int REFINEMENT_STRATA = 4;
+
+	//world space hit point and color of a primary ray, kept so the next preview frame can reuse it
+	struct ReprojectionSample
+	{
+		float m_x = 0.0f;
+		float m_y = 0.0f;
+		float m_z = 0.0f;
+		float m_red = 0.0f;
+		float m_green = 0.0f;
+		float m_blue = 0.0f;
+		float m_depth = 0.0f;
+		int m_age = -1;
+	};
+
+	bool m_temporalReprojection = true;
+	int m_reprojectionFrame = 0;
+	std::vector<ReprojectionSample> m_reprojectionSamples;
+	std::vector<ReprojectionSample> m_reprojectedSamples;
+
+	bool m_adaptiveShadows = true;
+	double m_minThroughput = 0.01;
+	double m_lightThreshold = 0.0;
+	int m_lightSampleCount = 0;
+	bool m_russianRoulette = false;
+	bool m_fresnelSelection = false;
+	int m_rayBudget = 0;
+	int m_tileRayBudget = 0;
+	mutable std::atomic<int64_t> m_cappedSamples{ 0 };
+
+	//set when the budget of the pixel sample the thread is tracing lowered a ray count
+	static thread_local bool m_rayBudgetCapped;
+	//rays the thread has intersected or tested for occlusion since its current tile started
+	static thread_local int64_t m_tracedRays;
+	mutable std::atomic<int64_t> m_softShadowPoints{ 0 };
+	mutable std::atomic<int64_t> m_softShadowRays{ 0 };
+	bool m_occluderCaching = true;
+	mutable std::atomic<int64_t> m_occluderLookups{ 0 };
+	mutable std::atomic<int64_t> m_occluderHits{ 0 };
+	mutable std::atomic<int64_t> m_occludedRays{ 0 };
+
+	static thread_local OccluderCache m_occluderCache;
+
+	bool m_wavefront = false;
+	bool m_raySorting = false;
+	Sampler::SamplerType m_samplerType = Sampler::SamplerType::STRATIFIED;
+
+	static constexpr int REPROJECTION_MAX_AGE = 48;
+	static constexpr double REPROJECTION_FAR = 100000.0;
+
+    //the throughput is the product of the reflectances and transparencies along the path, i.e. how much the ray can still add to its pixel,
+    //the budget is the number of rays the ray and everything it spawns may cost
+    Color traceRay(const CompiledScene& scene, const SamplePath& path, const Ray& ray, int recursion, double budget, double throughput = 1.0, double* hitDistance = nullptr) const;
+
+    //budget of the next primary or supersampling ray of a tile that has traced the given number of rays so far, an equal share 
+    //of what is left of the tile budget among the rays the tile still has to start, infinite if neither budget is set, 
+    //the reprojection and refinement passes do not run tile by tile and count one tile full of their samples per pass
+    double getSampleRayBudget(int64_t tracedRays, int raysLeft) const;
+
+    Intersection getIntersection(const CompiledScene& scene, const Ray& ray) const;
+
+    void countSoftShadowRays(int64_t points, int64_t rays) const;
+
+    void countCappedSamples(int64_t samples) const;
+
+    void countOccluderLookups(int64_t lookups, int64_t hits, int64_t occluded) const;
+
+    void countWavefrontStatistics(WavefrontTracer& tracer) const;
+
+    //moves the counts of the calling thread's occluder cache to the render's statistics
+    void flushOccluderStatistics() const;
+
+    bool isOccluded(const CompiledScene& scene, const Ray& ray, int light) const;
+
+    //share of the light reflected where a ray going from a medium with index n1 into one with index n2 meets a surface, 1 on total internal reflection
+    static double fresnel(const Vector& incident, const Vector& normal, double n1, double n2);
+
+    void presentTile(const Tile& tile);
+
+    void presentImage();
 
-    Color traceRay(const Ray& ray, int recursion) const;
+    void swapImages();
 
-    Intersection getIntersection(const Ray& ray) const;
+    bool renderTile(const CompiledScene& scene, const Tile& tile, int stepSize, bool temporalReprojection);
 
-    double fresnel(const Vector& incident, const Vector& normal, double n1, double n2, bool out) const;
+    bool renderTileWavefront(const CompiledScene& scene, const Tile& tile, int stepSize, bool temporalReprojection);
+
+    //blends the four supersampling rays of the pixel into its color, raysLeft are the other rays the tile still has to start
+    void superSample(const CompiledScene& scene, int x, int y, int raysLeft, Color& color) const;
+
+    void storeReprojectionSample(int x, int y, const Ray& ray, double hitDistance, const Color& color);
+
+    int renderReprojection(const CompiledScene& scene);
 
 public:
 
 	static std::string DESCRIPTION_LABEL;
 
+	static constexpr int TILE_SIZE = 32;
+
+	//soft shadows first fire this many rays and only spend the whole budget in the penumbra
+	static constexpr int SHADOW_PROBE_RAYS = 4;
+
+	//sample dimension of the Russian roulette decision, apart from the ones of the lights and the reflection and refraction
+	static constexpr int ROULETTE_DIMENSION = -1;
+
+	//sample dimension of the stochastic light selection
+	static constexpr int LIGHT_DIMENSION = -2;
+
+	//sample dimension of the choice between reflection and refraction
+	static constexpr int FRESNEL_DIMENSION = -3;
+
+    //fills the list with the lights a shading point has to visit, every light whose contribution bound reaches the threshold, 
+    //or sampleCount lights drawn by importance if the scene has more lights than that
+    static void selectLights(const LightTree& lightTree, const Sampler& sampler, const SamplePath& path, const Vector& point, const Vector& normal, 
+        const MaterialProperties& materialProperties, double threshold, int sampleCount, std::vector<LightTree::LightSample>& lights);
+
+    //probability with which a reflected or refracted ray of the given throughput is traced, 0 if the path ends here
+    static double getSurvivalProbability(const SamplePath& path, double throughput, double minThroughput, bool russianRoulette);
+
+    //moves the share of the transparency the Fresnel term reflects over to the reflectance, then keeps only one of the two,
+    //picked with a probability proportional to its weight and carrying the sum of both so nothing is lost on average
+    static void selectFresnelBranch(const SamplePath& path, const Vector& incident, const Vector& normal, double refractionIndex, bool out,
+        double& reflectance, double& transparency);
+
+    //splits what is left of a hit's budget after the ray itself and one shadow ray per light equally between the soft shadows, the reflection 
+    //and the refraction that want more rays, lowers their counts to what the shares afford and gives every reflected or refracted ray 
+    //an equal part of its share, the counts are 0 where an effect is not wanted, returns true if a count had to be lowered
+    static bool splitRayBudget(double budget, int lightCount, int softLightCount, int& shadowRayCount, int& reflectionCount, double& reflectionBudget, 
+        int& refractionCount, double& refractionBudget);
+
+    //point of the index-th shadow ray towards a light when the first probeRayCount rays are probes
+    static void getShadowSample(const Sampler& sampler, const SamplePath& path, int light, int index, int probeRayCount, int shadowRayCount, double& u, double& v);
+
     RayTracer() = default;
 
     RayTracer(int width, int height, Scene* scene = nullptr, Camera* camera = nullptr);
@@ -68,8 +223,13 @@ public:
 
     bool getPreviewMode() const;
 
+    bool getPreviewShadows() const;
+
     int getSubSamplingSize() const;
 
+    //the subsampling size preview frames are actually rendered with
+    int getPreviewSubSamplingSize() const;
+
     int getRecursion() const;
 
     int getShadowDist() const;
@@ -78,14 +238,69 @@ public:
 
     int getRefractionDist() const;
 
-    const Image& getImage() const;
+    int getThreadCount() const;
+
+    bool getProgressiveRefinement() const;
+
+    int getRefinementUpdateInterval() const;
+
+    int getRefinementMaxSamples() const;
+
+    double getRefinementNoiseThreshold() const;
+
+    int getAccumulatedSamples() const;
+
+    double getRefinementNoise() const;
+
+    int getCancelLatency() const;
+
+    TileScheduler::TileOrder getTileOrder() const;
 
-    const unsigned char* getPixmap() const;
+    RenderListener* getRenderListener() const;
+
+    bool getTemporalReprojection() const;
+
+    bool getWavefront() const;
+
+    bool getRaySorting() const;
+
+    Sampler::SamplerType getSamplerType() const;
+
+    bool getAdaptiveShadows() const;
+
+    bool getOccluderCaching() const;
+
+    bool getFresnelSelection() const;
+
+    int getRayBudget() const;
+
+    int getTileRayBudget() const;
+
+    //pixel samples of the last render whose ray budget lowered the number of shadow, reflected or refracted rays somewhere in their tree
+    int64_t getCappedSamples() const;
+
+    //shadow rays tested through the occluder caches during the last render, the ones the cached shape answered and the ones blocked at all
+    void getOccluderStatistics(int64_t& lookups, int64_t& hits, int64_t& occluded) const;
+
+    double getLightThreshold() const;
+
+    int getLightSampleCount() const;
+
+    double getMinThroughput() const;
+
+    bool getRussianRoulette() const;
+
+    //shadow rays traced per shading point and soft shadowed light during the last render
+    double getAverageShadowRays() const;
+
+    void readFrontImage(const std::function<void(const Image&)>& reader) const;
 
 	std::string toDescription() const override;
 
 	void init(Scene* scene, Camera* camera);
 
+    void setRenderListener(RenderListener* renderListener);
+
 	void set(const std::string& description);
 
     void setSize(int width, int height);
@@ -98,8 +313,13 @@ public:
 
     void setPreviewMode(bool previewMode);
 
+    void setPreviewShadows(bool previewShadows);
+
     void setSubSamplingSize(int subSamplingSize);
 
+    //overrides the subsampling size of preview frames without touching the configured one, 0 goes back to it
+    void setPreviewSubSamplingSize(int subSamplingSize);
+
     void setRecursion(int recursion);
 
     void setShadowDist(int shadowDist);
@@ -108,12 +328,78 @@ public:
 
     void setRefractionDist(int refractionDist);
 
+    void setThreadCount(int threadCount);
+
+    void setProgressiveRefinement(bool progressiveRefinement);
+
+    void setRefinementUpdateInterval(int passes);
+
+    void setRefinementMaxSamples(int samples);
+
+    void setRefinementNoiseThreshold(double threshold);
+
+    void setTileOrder(TileScheduler::TileOrder tileOrder);
+
+    void setRegionOfInterest(int x, int y);
+
+    void setTemporalReprojection(bool temporalReprojection);
+
+    //traces the tiles of render() and renderRegion() with queues of rays instead of recursively per pixel
+    void setWavefront(bool wavefront);
+
+    //sorts the queued secondary rays of the wavefront tracer by origin and direction before they are intersected, 
+    //off by default since it only pays off in scenes with many shapes such as meshes and costs time in scenes of a few quadrics
+    void setRaySorting(bool raySorting);
+
+    //how the points of soft shadows and blurry reflections and refractions are chosen
+    void setSamplerType(Sampler::SamplerType samplerType);
+
+    //stops after a few shadow rays where they all agree and the point is fully lit or fully shadowed
+    void setAdaptiveShadows(bool adaptiveShadows);
+
+    //tests the shape that blocked the previous shadow ray towards the same light first
+    void setOccluderCaching(bool occluderCaching);
+
+    //transparent surfaces follow either the reflection or the refraction, chosen by the Fresnel term, instead of both
+    void setFresnelSelection(bool fresnelSelection);
+
+    //rays a pixel sample may spend, the distribution counts shrink down its ray tree to stay within it, 0 for no limit
+    void setRayBudget(int rayBudget);
+
+    //rays a tile may spend, shared equally by its pixel samples, 0 for no limit
+    void setTileRayBudget(int tileRayBudget);
+
+    //lights that can add less than this to a shading point are skipped, 0 only skips the ones below its horizon
+    void setLightThreshold(double threshold);
+
+    //lights sampled by importance per shading point when a scene has more lights than this, 0 visits all of them
+    void setLightSampleCount(int sampleCount);
+
+    //reflected and refracted rays whose throughput falls below this end the path, 0 leaves only the recursion depth
+    void setMinThroughput(double minThroughput);
+
+    //keeps ending paths alive at random with a probability proportional to their throughput instead of dropping them
+    void setRussianRoulette(bool russianRoulette);
+
+    void invalidateReprojection();
+
     int render();
 
-    void cancelRendering();
+    //renders with a scene compiled from the ray tracer's scene beforehand, so several renders of an unchanged scene can share it
+    int render(const CompiledScene& scene);
+
+    //renders one tile of the final image and returns its pixels row by row, 
+    //several threads can render different tiles at the same time, 
+    //the scene is compiled once per job from the ray tracer's scene and shared by all its tiles
+    bool renderRegion(const CompiledScene& scene, const Tile& tile, std::vector<Color>& pixels);
+
+    int refine();
 
-signals:
+    int refine(const CompiledScene& scene);
 
-    void lineFinished();
+    void resetAccumulation();
+
+    void cancelRendering();
 
+    void resetCancellation();
 };
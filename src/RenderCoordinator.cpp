@@ -0,0 +1,266 @@
+#include <poll.h>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include "RenderCoordinator.h"
+#include "RenderProtocol.h"
+#include "SettingsIO.h"
+
+bool RenderCoordinator::listen(const std::string& address)
+{
+	m_listener = Socket::listen(address);
+
+	return m_listener != nullptr;
+}
+
+void RenderCoordinator::setRenderListener(RenderListener* renderListener)
+{
+	m_renderListener = renderListener;
+}
+
+void RenderCoordinator::setWorkerTimeout(int seconds)
+{
+	m_workerTimeout = seconds;
+}
+
+void RenderCoordinator::setResponseTimeout(int seconds)
+{
+	m_responseTimeout = seconds;
+}
+
+int RenderCoordinator::getLostWorkers() const
+{
+	return m_lostWorkers;
+}
+
+int RenderCoordinator::getReissuedTiles() const
+{
+	return m_reissuedTiles;
+}
+
+void RenderCoordinator::acceptWorker(const std::string& scenePayload)
+{
+	std::unique_ptr<Socket> socket = m_listener->accept();
+	if (socket == nullptr)
+	{
+		return;
+	}
+
+	if (!socket->sendMessage(static_cast<uint32_t>(RenderProtocol::MessageType::SCENE), scenePayload))
+	{
+		return;
+	}
+
+	//tiles are only handed out after the worker has told how many it can render at once
+	Worker worker;
+	worker.m_socket = std::move(socket);
+	worker.m_lastActivity = std::chrono::steady_clock::now();
+	m_workers.push_back(std::move(worker));
+}
+
+void RenderCoordinator::loseWorker(size_t index, std::vector<int>& pendingTiles)
+{
+	Worker& worker = m_workers[index];
+
+	//the lost tiles go to the back of the stack so they are issued next
+	pendingTiles.insert(pendingTiles.end(), worker.m_assignedTiles.rbegin(), worker.m_assignedTiles.rend());
+	m_reissuedTiles += static_cast<int>(worker.m_assignedTiles.size());
+	m_lostWorkers++;
+
+	m_workers.erase(m_workers.begin() + index);
+}
+
+bool RenderCoordinator::render(Scene& scene, const RayTracer& rayTracer, int width, int height, Image& image)
+{
+	if (m_listener == nullptr)
+	{
+		return false;
+	}
+
+	m_lostWorkers = 0;
+	m_reissuedTiles = 0;
+
+	std::stringstream ss;
+	SettingsIO::writeSettings(ss, scene, rayTracer);
+
+	std::string scenePayload;
+	RenderProtocol::writeInt(scenePayload, width);
+	RenderProtocol::writeInt(scenePayload, height);
+	scenePayload += ss.str();
+
+	std::vector<Tile> tiles = TileScheduler::createTiles(width, height, RayTracer::TILE_SIZE, rayTracer.getTileOrder());
+	std::vector<bool> finished(tiles.size(), false);
+	size_t finishedCount = 0;
+
+	//used as a stack, so the tiles are stored in reverse order
+	std::vector<int> pendingTiles;
+	for (int i = static_cast<int>(tiles.size()) - 1; i >= 0; --i)
+	{
+		pendingTiles.push_back(i);
+	}
+
+	image = Image(width, height);
+
+	std::chrono::steady_clock::time_point idleSince = std::chrono::steady_clock::now();
+	std::vector<Color> pixels;
+
+	while (finishedCount < tiles.size())
+	{
+		for (size_t i = 0; i < m_workers.size(); )
+		{
+			Worker& worker = m_workers[i];
+			bool lost = false;
+
+			//an idle worker's silence only counts from the moment it is given tiles
+			if (worker.m_assignedTiles.empty() && worker.m_capacity > 0)
+			{
+				worker.m_lastActivity = std::chrono::steady_clock::now();
+			}
+
+			//a worker that is still connected but stopped answering would otherwise keep its tiles forever
+			if ((!worker.m_assignedTiles.empty() || worker.m_capacity == 0) 
+				&& std::chrono::steady_clock::now() - worker.m_lastActivity > std::chrono::seconds(m_responseTimeout))
+			{
+				loseWorker(i, pendingTiles);
+				continue;
+			}
+
+			while (!lost && static_cast<int>(worker.m_assignedTiles.size()) < worker.m_capacity && !pendingTiles.empty())
+			{
+				int id = pendingTiles.back();
+				pendingTiles.pop_back();
+				worker.m_assignedTiles.push_back(id);
+
+				lost = !worker.m_socket->sendMessage(static_cast<uint32_t>(RenderProtocol::MessageType::TILE), RenderProtocol::encodeTile(id, tiles[id]));
+			}
+
+			if (lost)
+			{
+				loseWorker(i, pendingTiles);
+			}
+			else
+			{
+				++i;
+			}
+		}
+
+		if (m_workers.empty())
+		{
+			if (std::chrono::steady_clock::now() - idleSince > std::chrono::seconds(m_workerTimeout))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			idleSince = std::chrono::steady_clock::now();
+		}
+
+		std::vector<pollfd> descriptors;
+		descriptors.push_back(pollfd{ m_listener->getDescriptor(), POLLIN, 0 });
+		for (const Worker& worker : m_workers)
+		{
+			descriptors.push_back(pollfd{ worker.m_socket->getDescriptor(), POLLIN, 0 });
+		}
+
+		if (::poll(descriptors.data(), descriptors.size(), 1000) <= 0)
+		{
+			continue;
+		}
+
+		//workers are checked from the back, so losing one does not shift the ones still to be checked
+		for (size_t i = m_workers.size(); i-- > 0; )
+		{
+			if (descriptors[i + 1].revents == 0)
+			{
+				continue;
+			}
+
+			Worker& worker = m_workers[i];
+			uint32_t type;
+			std::string payload;
+
+			if (!worker.m_socket->receiveMessage(type, payload))
+			{
+				loseWorker(i, pendingTiles);
+				continue;
+			}
+
+			worker.m_lastActivity = std::chrono::steady_clock::now();
+
+			if (type == static_cast<uint32_t>(RenderProtocol::MessageType::HELLO))
+			{
+				size_t offset = 0;
+				int32_t version = 0;
+				int32_t threadCount = 0;
+
+				if (!RenderProtocol::readInt(payload, offset, version) || !RenderProtocol::readInt(payload, offset, threadCount) || version != RenderProtocol::VERSION)
+				{
+					loseWorker(i, pendingTiles);
+					continue;
+				}
+
+				//two tiles per thread keep a worker busy while its results travel back
+				worker.m_capacity = 2 * std::max(1, static_cast<int>(threadCount));
+			}
+			else if (type == static_cast<uint32_t>(RenderProtocol::MessageType::RESULT))
+			{
+				int id;
+				Tile tile;
+
+				if (!RenderProtocol::decodeResult(payload, id, tile, pixels) || id < 0 || id >= static_cast<int>(tiles.size()))
+				{
+					loseWorker(i, pendingTiles);
+					continue;
+				}
+
+				auto it = std::find(worker.m_assignedTiles.begin(), worker.m_assignedTiles.end(), id);
+				if (it != worker.m_assignedTiles.end())
+				{
+					worker.m_assignedTiles.erase(it);
+				}
+
+				const Tile& expected = tiles[id];
+				if (tile.m_x != expected.m_x || tile.m_y != expected.m_y || tile.m_width != expected.m_width || tile.m_height != expected.m_height)
+				{
+					loseWorker(i, pendingTiles);
+					continue;
+				}
+
+				if (finished[id] == false)
+				{
+					for (int y = 0; y < expected.m_height; ++y)
+					{
+						for (int x = 0; x < expected.m_width; ++x)
+						{
+							image.putPixel(expected.m_x + x, expected.m_y + y, pixels[y * expected.m_width + x]);
+						}
+					}
+
+					finished[id] = true;
+					finishedCount++;
+
+					if (m_renderListener != nullptr)
+					{
+						m_renderListener->onTileFinished(expected);
+					}
+				}
+			}
+		}
+
+		if (descriptors[0].revents != 0)
+		{
+			acceptWorker(scenePayload);
+		}
+	}
+
+	for (Worker& worker : m_workers)
+	{
+		worker.m_socket->sendMessage(static_cast<uint32_t>(RenderProtocol::MessageType::SHUTDOWN), std::string());
+	}
+	m_workers.clear();
+
+	return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Image.h"
+#include "RayTracer.h"
+#include "RenderListener.h"
+#include "Scene.h"
+#include "Socket.h"
+#include "TileScheduler.h"
+
+//hands out the tiles of a final render to worker processes and assembles their results,
+//tiles of a lost worker are issued again to the remaining ones
+class RenderCoordinator
+{
+private:
+
+	struct Worker
+	{
+		std::unique_ptr<Socket> m_socket;
+		int m_capacity = 0;
+		std::vector<int> m_assignedTiles;
+		//last message from the worker, or the time it was given work while it had none
+		std::chrono::steady_clock::time_point m_lastActivity;
+	};
+
+	std::unique_ptr<Socket> m_listener;
+	std::vector<Worker> m_workers;
+	int m_workerTimeout = 30;
+	int m_responseTimeout = 300;
+	int m_lostWorkers = 0;
+	int m_reissuedTiles = 0;
+	RenderListener* m_renderListener = nullptr;
+
+	void acceptWorker(const std::string& scenePayload);
+
+	void loseWorker(size_t index, std::vector<int>& pendingTiles);
+
+public:
+
+	RenderCoordinator() = default;
+
+	RenderCoordinator(const RenderCoordinator& other) = delete;
+
+	RenderCoordinator(RenderCoordinator&& other) = delete;
+
+	RenderCoordinator& operator=(const RenderCoordinator& other) = delete;
+
+	RenderCoordinator& operator=(RenderCoordinator&& other) = delete;
+
+	~RenderCoordinator() = default;
+
+	bool listen(const std::string& address);
+
+	void setRenderListener(RenderListener* renderListener);
+
+	//seconds to wait while no worker is connected before the render fails
+	void setWorkerTimeout(int seconds);
+
+	//seconds a worker may stay silent while it owes tiles or has not said hello before it counts as lost and its tiles are issued again
+	void setResponseTimeout(int seconds);
+
+	int getLostWorkers() const;
+
+	int getReissuedTiles() const;
+
+	//the scene is sent to every worker once when it connects, returns false if the render could not be completed
+	bool render(Scene& scene, const RayTracer& rayTracer, int width, int height, Image& image);
+};
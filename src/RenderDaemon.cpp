@@ -0,0 +1,154 @@
+#include <chrono>
+#include <sstream>
+
+#include "RenderDaemon.h"
+#include "RenderProtocol.h"
+
+bool RenderDaemon::listen(const std::string& address)
+{
+	m_listener = Socket::listen(address);
+
+	return m_listener != nullptr;
+}
+
+void RenderDaemon::setCacheCapacity(size_t capacity)
+{
+	m_sceneCache.setCapacity(capacity);
+}
+
+void RenderDaemon::run()
+{
+	if (m_listener == nullptr)
+	{
+		return;
+	}
+
+	while (true)
+	{
+		std::unique_ptr<Socket> client = m_listener->accept();
+
+		if (client != nullptr && !serveClient(*client))
+		{
+			return;
+		}
+	}
+}
+
+bool RenderDaemon::serveClient(Socket& client)
+{
+	uint32_t type;
+	std::string payload;
+
+	//a client can send several jobs over the same connection
+	while (client.receiveMessage(type, payload))
+	{
+		if (type == static_cast<uint32_t>(RenderProtocol::MessageType::SHUTDOWN))
+		{
+			client.sendMessage(static_cast<uint32_t>(RenderProtocol::MessageType::JOB_RESULT), std::string(4, '\0'));
+			return false;
+		}
+
+		if (type != static_cast<uint32_t>(RenderProtocol::MessageType::JOB))
+		{
+			break;
+		}
+
+		RenderJob job;
+		std::string log;
+		bool succeeded = false;
+
+		if (job.fromDescription(payload))
+		{
+			succeeded = renderJob(job, log);
+		}
+		else
+		{
+			log = "Invalid job description\n";
+		}
+
+		std::string result;
+		RenderProtocol::writeInt(result, succeeded ? 0 : 1);
+		result += log;
+
+		if (!client.sendMessage(static_cast<uint32_t>(RenderProtocol::MessageType::JOB_RESULT), result))
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool RenderDaemon::renderJob(const RenderJob& job, std::string& log)
+{
+	std::stringstream ss;
+
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+	bool cached = false;
+	std::shared_ptr<CachedScene> cachedScene = m_sceneCache.get(job.m_sceneFile, cached);
+
+	if (cachedScene == nullptr)
+	{
+		log = "Unable to load scene " + job.m_sceneFile + "\n";
+		return false;
+	}
+
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	m_jobCount++;
+
+	ss << "Job " << m_jobCount << ", scene " << (cached ? "cached" : "loaded") << " in " 
+		<< std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() / 1000000.0 << " s\n";
+
+	//the cached scene is shared by all jobs, so the camera override goes to a copy of its camera
+	std::unique_ptr<Camera> camera = cachedScene->m_scene.getCamera()->clone();
+	job.applyCamera(*camera);
+
+	RayTracer rayTracer;
+	rayTracer.set(cachedScene->m_rayTracerSettings);
+	rayTracer.init(&cachedScene->m_scene, camera.get());
+	job.applySettings(rayTracer);
+
+	bool succeeded = job.execute(rayTracer, *cachedScene->m_compiledScene, ss);
+
+	log = ss.str();
+
+	return succeeded;
+}
+
+bool RenderDaemon::submit(const std::string& address, const RenderJob& job, std::string& log)
+{
+	std::unique_ptr<Socket> socket = Socket::connect(address);
+
+	uint32_t type;
+	std::string payload;
+
+	if (socket == nullptr 
+		|| !socket->sendMessage(static_cast<uint32_t>(RenderProtocol::MessageType::JOB), job.toDescription()) 
+		|| !socket->receiveMessage(type, payload) 
+		|| type != static_cast<uint32_t>(RenderProtocol::MessageType::JOB_RESULT))
+	{
+		log = "Unable to reach the render daemon at " + address + "\n";
+		return false;
+	}
+
+	size_t offset = 0;
+	int32_t status = 1;
+	RenderProtocol::readInt(payload, offset, status);
+	log = payload.substr(std::min(offset, payload.size()));
+
+	return status == 0;
+}
+
+bool RenderDaemon::shutdown(const std::string& address)
+{
+	std::unique_ptr<Socket> socket = Socket::connect(address);
+
+	uint32_t type;
+	std::string payload;
+
+	return socket != nullptr 
+		&& socket->sendMessage(static_cast<uint32_t>(RenderProtocol::MessageType::SHUTDOWN), std::string()) 
+		&& socket->receiveMessage(type, payload);
+}
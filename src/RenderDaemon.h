@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "RenderJob.h"
+#include "SceneCache.h"
+#include "Socket.h"
+
+//a long running render service, it keeps parsed scenes cached so repeated jobs on the same scene skip all loading
+class RenderDaemon
+{
+private:
+
+	std::unique_ptr<Socket> m_listener;
+	SceneCache m_sceneCache;
+	int m_jobCount = 0;
+
+	//returns false when the client asked the daemon to stop
+	bool serveClient(Socket& client);
+
+	bool renderJob(const RenderJob& job, std::string& log);
+
+public:
+
+	RenderDaemon() = default;
+
+	RenderDaemon(const RenderDaemon& other) = delete;
+
+	RenderDaemon(RenderDaemon&& other) = delete;
+
+	RenderDaemon& operator=(const RenderDaemon& other) = delete;
+
+	RenderDaemon& operator=(RenderDaemon&& other) = delete;
+
+	~RenderDaemon() = default;
+
+	bool listen(const std::string& address);
+
+	void setCacheCapacity(size_t capacity);
+
+	//serves clients one after the other until one of them sends a shutdown message
+	void run();
+
+	//sends one job to a running daemon and returns its log, returns false if the job failed
+	static bool submit(const std::string& address, const RenderJob& job, std::string& log);
+
+	static bool shutdown(const std::string& address);
+};
@@ -0,0 +1,152 @@
+#include "RenderHandle.h"
+
+RenderHandle::RenderHandle(WorkerPool& workerPool, Scene* scene, const Camera& camera, const RayTracer& settings, int width, int height, TileCallback tileCallback)
+	: m_workerPool(workerPool)
+	, m_camera(camera.clone())
+	, m_compiledScene(*scene)
+	, m_tileCallback(std::move(tileCallback))
+	, m_image(width, height)
+	, m_future(m_promise.get_future().share())
+{
+	m_rayTracer.set(settings.toDescription());
+	m_rayTracer.init(scene, m_camera.get());
+	m_rayTracer.setSize(width, height);
+	m_rayTracer.setPreviewMode(false);
+	m_rayTracer.setTemporalReprojection(false);
+
+	m_tiles = TileScheduler::createTiles(width, height, RayTracer::TILE_SIZE, settings.getTileOrder());
+}
+
+RenderHandle::~RenderHandle()
+{
+	//a job dropped by its pool still gets a result instead of a broken promise
+	if (!m_finished.exchange(true))
+	{
+		RenderStatistics statistics;
+		statistics.m_tileCount = static_cast<int>(m_tiles.size());
+		statistics.m_finishedTiles = m_finishedTiles;
+		statistics.m_cancelled = true;
+
+		m_promise.set_value(statistics);
+	}
+}
+
+std::shared_ptr<RenderHandle> RenderHandle::submit(WorkerPool& workerPool, Scene* scene, const Camera& camera, const RayTracer& settings,
+	int width, int height, TileCallback tileCallback)
+{
+	std::shared_ptr<RenderHandle> handle(new RenderHandle(workerPool, scene, camera, settings, width, height, std::move(tileCallback)));
+
+	handle->m_startTime = std::chrono::high_resolution_clock::now();
+
+	int taskCount = std::min(workerPool.getThreadCount(), static_cast<int>(handle->m_tiles.size()));
+	if (taskCount == 0)
+	{
+		handle->finish();
+		return handle;
+	}
+
+	handle->m_activeTasks = taskCount;
+	for (int i = 0; i < taskCount; ++i)
+	{
+		workerPool.submit([handle]() { handle->renderNextTile(); });
+	}
+
+	return handle;
+}
+
+void RenderHandle::renderNextTile()
+{
+	size_t t = m_nextTile++;
+
+	if (t < m_tiles.size() && !m_cancellationToken.isCancelled())
+	{
+		const Tile& tile = m_tiles[t];
+		std::vector<Color> pixels;
+
+		if (m_rayTracer.renderRegion(m_compiledScene, tile, pixels))
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_imageMutex);
+				for (int y = 0; y < tile.m_height; ++y)
+				{
+					for (int x = 0; x < tile.m_width; ++x)
+					{
+						m_image.putPixel(tile.m_x + x, tile.m_y + y, pixels[y * tile.m_width + x]);
+					}
+				}
+			}
+
+			m_finishedTiles++;
+
+			if (m_tileCallback)
+			{
+				m_tileCallback(*this, tile);
+			}
+		}
+
+		if (m_nextTile < m_tiles.size() && !m_cancellationToken.isCancelled())
+		{
+			std::shared_ptr<RenderHandle> self = shared_from_this();
+			m_workerPool.submit([self]() { self->renderNextTile(); });
+			return;
+		}
+	}
+
+	if (--m_activeTasks == 0)
+	{
+		finish();
+	}
+}
+
+void RenderHandle::finish()
+{
+	if (m_finished.exchange(true))
+	{
+		return;
+	}
+
+	std::chrono::high_resolution_clock::time_point endTime = std::chrono::high_resolution_clock::now();
+
+	RenderStatistics statistics;
+	statistics.m_microseconds = static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(endTime - m_startTime).count());
+	statistics.m_tileCount = static_cast<int>(m_tiles.size());
+	statistics.m_finishedTiles = m_finishedTiles;
+	statistics.m_cancelled = statistics.m_finishedTiles < statistics.m_tileCount;
+
+	m_promise.set_value(statistics);
+}
+
+std::shared_future<RenderStatistics> RenderHandle::getFuture() const
+{
+	return m_future;
+}
+
+double RenderHandle::getProgress() const
+{
+	return m_tiles.empty() ? 1.0 : static_cast<double>(m_finishedTiles) / m_tiles.size();
+}
+
+bool RenderHandle::isFinished() const
+{
+	return m_finished;
+}
+
+void RenderHandle::cancel()
+{
+	m_cancellationToken.cancel();
+	m_rayTracer.cancelRendering();
+}
+
+Image RenderHandle::getImage() const
+{
+	std::lock_guard<std::mutex> lock(m_imageMutex);
+
+	return m_image;
+}
+
+void RenderHandle::readImage(const std::function<void(const Image&)>& reader) const
+{
+	std::lock_guard<std::mutex> lock(m_imageMutex);
+
+	reader(m_image);
+}
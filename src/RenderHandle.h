@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "Camera.h"
+#include "CompiledScene.h"
+#include "Image.h"
+#include "RayTracer.h"
+#include "Scene.h"
+#include "TileScheduler.h"
+#include "WorkerPool.h"
+
+struct RenderStatistics
+{
+	int m_microseconds = 0;
+	int m_tileCount = 0;
+	int m_finishedTiles = 0;
+	bool m_cancelled = false;
+};
+
+//an asynchronous final render of one view, its tiles are rendered by a worker pool that can be shared with other jobs
+class RenderHandle : public std::enable_shared_from_this<RenderHandle>
+{
+public:
+
+	using TileCallback = std::function<void(const RenderHandle& handle, const Tile& tile)>;
+
+private:
+
+	WorkerPool& m_workerPool;
+	std::unique_ptr<Camera> m_camera;
+	RayTracer m_rayTracer;
+	CompiledScene m_compiledScene;
+	std::vector<Tile> m_tiles;
+	TileCallback m_tileCallback;
+
+	Image m_image;
+	mutable std::mutex m_imageMutex;
+
+	std::atomic<size_t> m_nextTile{ 0 };
+	std::atomic<int> m_finishedTiles{ 0 };
+	std::atomic<int> m_activeTasks{ 0 };
+	CancellationToken m_cancellationToken;
+	std::chrono::high_resolution_clock::time_point m_startTime;
+
+	std::promise<RenderStatistics> m_promise;
+	std::shared_future<RenderStatistics> m_future;
+	std::atomic<bool> m_finished{ false };
+
+	RenderHandle(WorkerPool& workerPool, Scene* scene, const Camera& camera, const RayTracer& settings, int width, int height, TileCallback tileCallback);
+
+	//renders one tile and queues itself again behind the other jobs' tasks, so concurrent jobs share the pool evenly
+	void renderNextTile();
+
+	void finish();
+
+public:
+
+	RenderHandle(const RenderHandle& other) = delete;
+
+	RenderHandle(RenderHandle&& other) = delete;
+
+	RenderHandle& operator=(const RenderHandle& other) = delete;
+
+	RenderHandle& operator=(RenderHandle&& other) = delete;
+
+	~RenderHandle();
+
+	//the scene is shared with the job and must not change until the future is ready, the camera and settings are copied,
+	//the tile callback is called from the pool threads after each finished tile
+	static std::shared_ptr<RenderHandle> submit(WorkerPool& workerPool, Scene* scene, const Camera& camera, const RayTracer& settings,
+		int width, int height, TileCallback tileCallback = nullptr);
+
+	std::shared_future<RenderStatistics> getFuture() const;
+
+	//fraction of finished tiles between 0 and 1
+	double getProgress() const;
+
+	bool isFinished() const;
+
+	//stops the job as soon as the tiles in progress notice it, the future is then ready with m_cancelled set
+	void cancel();
+
+	//the finished tiles so far, the rest is black
+	Image getImage() const;
+
+	void readImage(const std::function<void(const Image&)>& reader) const;
+};
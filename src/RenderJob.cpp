@@ -0,0 +1,226 @@
+#include <sstream>
+
+#include "RenderJob.h"
+#include "Utility.h"
+
+bool RenderJob::setCamera(const std::string& camera)
+{
+	std::vector<std::string> list = Utility::split(camera, ',');
+
+	if (list.size() != 9)
+	{
+		return false;
+	}
+
+	try
+	{
+		m_cameraPosition = Vector(std::stod(list[0]), std::stod(list[1]), std::stod(list[2]));
+		m_cameraDirection = Vector(std::stod(list[3]), std::stod(list[4]), std::stod(list[5]));
+		m_cameraUp = Vector(std::stod(list[6]), std::stod(list[7]), std::stod(list[8]));
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+
+	m_cameraOverride = true;
+
+	return true;
+}
+
+void RenderJob::applySettings(RayTracer& rayTracer) const
+{
+	rayTracer.setSize(m_width, m_height);
+	rayTracer.setPreviewMode(false);
+	rayTracer.setTemporalReprojection(false);
+
+	if (m_threadCount > 0) rayTracer.setThreadCount(m_threadCount);
+	if (m_recursion >= 0) rayTracer.setRecursion(m_recursion);
+	if (m_shadowDist > 0) rayTracer.setShadowDist(m_shadowDist);
+	if (m_reflectionDist > 0) rayTracer.setReflectionDist(m_reflectionDist);
+	if (m_refractionDist > 0) rayTracer.setRefractionDist(m_refractionDist);
+	if (m_adaptiveSuperSampling >= 0) rayTracer.setAdaptiveSuperSampling(m_adaptiveSuperSampling != 0);
+	if (m_superSamplingThreshold >= 0.0) rayTracer.setSuperSamplingThreshold(m_superSamplingThreshold);
+	if (m_wavefront >= 0) rayTracer.setWavefront(m_wavefront != 0);
+	if (m_raySorting >= 0) rayTracer.setRaySorting(m_raySorting != 0);
+	if (m_adaptiveShadows >= 0) rayTracer.setAdaptiveShadows(m_adaptiveShadows != 0);
+	if (m_minThroughput >= 0.0) rayTracer.setMinThroughput(m_minThroughput);
+	if (m_russianRoulette >= 0) rayTracer.setRussianRoulette(m_russianRoulette != 0);
+	if (m_lightThreshold >= 0.0) rayTracer.setLightThreshold(m_lightThreshold);
+	if (m_lightSampleCount >= 0) rayTracer.setLightSampleCount(m_lightSampleCount);
+	if (m_occluderCaching >= 0) rayTracer.setOccluderCaching(m_occluderCaching != 0);
+	if (m_fresnelSelection >= 0) rayTracer.setFresnelSelection(m_fresnelSelection != 0);
+	if (m_rayBudget >= 0) rayTracer.setRayBudget(m_rayBudget);
+	if (m_tileRayBudget >= 0) rayTracer.setTileRayBudget(m_tileRayBudget);
+	if (m_samplerType >= 0) rayTracer.setSamplerType(static_cast<Sampler::SamplerType>(m_samplerType));
+}
+
+void RenderJob::applyCamera(Camera& camera) const
+{
+	if (m_cameraOverride == false)
+	{
+		return;
+	}
+
+	Vector direction = normalize(m_cameraDirection);
+	Vector right = normalize(cross(direction, m_cameraUp));
+
+	camera.setPosition(m_cameraPosition);
+	camera.setDirection(direction);
+	camera.setRight(right);
+	camera.setUp(cross(right, direction));
+}
+
+bool RenderJob::execute(RayTracer& rayTracer, const CompiledScene& scene, std::ostream& log) const
+{
+	int renderTime = rayTracer.render(scene);
+
+	log << "Rendered " << m_width << "x" << m_height << " with " << rayTracer.getThreadCount() << " threads in " 
+		<< renderTime / 1000000.0 << " s\n";
+
+	logStatistics(rayTracer, log);
+
+	if (m_samples > 1)
+	{
+		rayTracer.setRefinementMaxSamples(m_samples);
+		rayTracer.setRefinementNoiseThreshold(m_noiseThreshold);
+		rayTracer.setRefinementUpdateInterval(m_samples);
+
+		int refineTime = rayTracer.refine(scene);
+
+		log << "Refined to " << rayTracer.getAccumulatedSamples() << " samples per pixel, noise " << rayTracer.getRefinementNoise() 
+			<< " in " << refineTime / 1000000.0 << " s\n";
+	}
+
+	bool saved = false;
+	rayTracer.readFrontImage([this, &saved](const Image& image)
+	{
+		saved = image.save(m_outputFile);
+	});
+
+	if (!saved)
+	{
+		log << "Unable to write " << m_outputFile << ", the extension has to be .bmp or .ppm\n";
+	}
+
+	return saved;
+}
+
+void RenderJob::logStatistics(const RayTracer& rayTracer, std::ostream& log)
+{
+	if (rayTracer.getAverageShadowRays() > 0.0)
+	{
+		log << "Soft shadows used " << rayTracer.getAverageShadowRays() << " of " << rayTracer.getShadowDist() << " shadow rays per point on average\n";
+	}
+
+	int64_t lookups;
+	int64_t hits;
+	int64_t occluded;
+	rayTracer.getOccluderStatistics(lookups, hits, occluded);
+
+	if (lookups > 0)
+	{
+		log << "Occluder cache answered " << 100.0 * hits / lookups << "% of " << lookups << " shadow rays, " 
+			<< (occluded > 0 ? 100.0 * hits / occluded : 0.0) << "% of the blocked ones\n";
+	}
+
+	if (rayTracer.getCappedSamples() > 0)
+	{
+		log << rayTracer.getCappedSamples() << " pixel samples reached their ray budget and traced fewer shadow, reflected or refracted rays\n";
+	}
+}
+
+std::string RenderJob::toDescription() const
+{
+	std::stringstream ss;
+
+	ss << "scene=" << m_sceneFile << "\n"
+		<< "output=" << m_outputFile << "\n"
+		<< "width=" << m_width << "\n"
+		<< "height=" << m_height << "\n"
+		<< "threads=" << m_threadCount << "\n"
+		<< "samples=" << m_samples << "\n"
+		<< "noise=" << m_noiseThreshold << "\n"
+		<< "recursion=" << m_recursion << "\n"
+		<< "shadowRays=" << m_shadowDist << "\n"
+		<< "reflectionRays=" << m_reflectionDist << "\n"
+		<< "refractionRays=" << m_refractionDist << "\n"
+		<< "supersampling=" << m_adaptiveSuperSampling << "\n"
+		<< "threshold=" << m_superSamplingThreshold << "\n"
+		<< "wavefront=" << m_wavefront << "\n"
+		<< "raySorting=" << m_raySorting << "\n"
+		<< "sampler=" << m_samplerType << "\n"
+		<< "adaptiveShadows=" << m_adaptiveShadows << "\n"
+		<< "minThroughput=" << m_minThroughput << "\n"
+		<< "russianRoulette=" << m_russianRoulette << "\n"
+		<< "lightThreshold=" << m_lightThreshold << "\n"
+		<< "lightSamples=" << m_lightSampleCount << "\n"
+		<< "occluderCache=" << m_occluderCaching << "\n"
+		<< "fresnelSelection=" << m_fresnelSelection << "\n"
+		<< "rayBudget=" << m_rayBudget << "\n"
+		<< "tileRayBudget=" << m_tileRayBudget << "\n";
+
+	if (m_cameraOverride == true)
+	{
+		ss << "camera="
+			<< m_cameraPosition.m_x << "," << m_cameraPosition.m_y << "," << m_cameraPosition.m_z << ","
+			<< m_cameraDirection.m_x << "," << m_cameraDirection.m_y << "," << m_cameraDirection.m_z << ","
+			<< m_cameraUp.m_x << "," << m_cameraUp.m_y << "," << m_cameraUp.m_z << "\n";
+	}
+
+	return ss.str();
+}
+
+bool RenderJob::fromDescription(const std::string& description)
+{
+	std::stringstream ss(description);
+	std::string line;
+
+	try
+	{
+		while (std::getline(ss, line))
+		{
+			size_t equals = line.find('=');
+			if (equals == std::string::npos)
+			{
+				continue;
+			}
+
+			std::string key = line.substr(0, equals);
+			std::string value = line.substr(equals + 1);
+
+			if (key == "scene") m_sceneFile = value;
+			else if (key == "output") m_outputFile = value;
+			else if (key == "width") m_width = std::stoi(value);
+			else if (key == "height") m_height = std::stoi(value);
+			else if (key == "threads") m_threadCount = std::stoi(value);
+			else if (key == "samples") m_samples = std::stoi(value);
+			else if (key == "noise") m_noiseThreshold = std::stod(value);
+			else if (key == "recursion") m_recursion = std::stoi(value);
+			else if (key == "shadowRays") m_shadowDist = std::stoi(value);
+			else if (key == "reflectionRays") m_reflectionDist = std::stoi(value);
+			else if (key == "refractionRays") m_refractionDist = std::stoi(value);
+			else if (key == "supersampling") m_adaptiveSuperSampling = std::stoi(value);
+			else if (key == "threshold") m_superSamplingThreshold = std::stod(value);
+			else if (key == "wavefront") m_wavefront = std::stoi(value);
+			else if (key == "raySorting") m_raySorting = std::stoi(value);
+			else if (key == "sampler") m_samplerType = std::stoi(value);
+			else if (key == "adaptiveShadows") m_adaptiveShadows = std::stoi(value);
+			else if (key == "minThroughput") m_minThroughput = std::stod(value);
+			else if (key == "russianRoulette") m_russianRoulette = std::stoi(value);
+			else if (key == "lightThreshold") m_lightThreshold = std::stod(value);
+			else if (key == "lightSamples") m_lightSampleCount = std::stoi(value);
+			else if (key == "occluderCache") m_occluderCaching = std::stoi(value);
+			else if (key == "fresnelSelection") m_fresnelSelection = std::stoi(value);
+			else if (key == "rayBudget") m_rayBudget = std::stoi(value);
+			else if (key == "tileRayBudget") m_tileRayBudget = std::stoi(value);
+			else if (key == "camera" && !setCamera(value)) return false;
+		}
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+
+	return !m_sceneFile.empty() && !m_outputFile.empty() && m_width > 0 && m_height > 0 && m_samples >= 1;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "Camera.h"
+#include "CompiledScene.h"
+#include "RayTracer.h"
+#include "Vector.h"
+
+//what to render and the settings that override the ones saved with the scene, negative values keep the scene's settings
+struct RenderJob
+{
+	std::string m_sceneFile;
+	std::string m_outputFile;
+	int m_width = 1280;
+	int m_height = 720;
+	int m_threadCount = 0;
+	int m_samples = 1;
+	double m_noiseThreshold = 0.0;
+	int m_recursion = -1;
+	int m_shadowDist = -1;
+	int m_reflectionDist = -1;
+	int m_refractionDist = -1;
+	int m_adaptiveSuperSampling = -1;
+	double m_superSamplingThreshold = -1.0;
+	int m_wavefront = -1;
+	int m_raySorting = -1;
+	int m_adaptiveShadows = -1;
+	double m_minThroughput = -1.0;
+	int m_russianRoulette = -1;
+	double m_lightThreshold = -1.0;
+	int m_lightSampleCount = -1;
+	int m_occluderCaching = -1;
+	int m_fresnelSelection = -1;
+	int m_rayBudget = -1;
+	int m_tileRayBudget = -1;
+	int m_samplerType = -1;
+	bool m_cameraOverride = false;
+	Vector m_cameraPosition;
+	Vector m_cameraDirection;
+	Vector m_cameraUp;
+
+	//"posX,posY,posZ,dirX,dirY,dirZ,upX,upY,upZ"
+	bool setCamera(const std::string& camera);
+
+	void applySettings(RayTracer& rayTracer) const;
+
+	void applyCamera(Camera& camera) const;
+
+	//renders the compiled form of the ray tracer's scene, refines if more than one sample is requested and saves the image, 
+	//progress is written to the log
+	bool execute(RayTracer& rayTracer, const CompiledScene& scene, std::ostream& log) const;
+
+	//writes what the last render spent on soft shadows, how well the occluder caches did and how many pixel samples ran out of rays
+	static void logStatistics(const RayTracer& rayTracer, std::ostream& log);
+
+	//one "key=value" line per field
+	std::string toDescription() const;
+
+	bool fromDescription(const std::string& description);
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "TileScheduler.h"
+
+//receives progress notifications from the ray tracer, the calls come from the render threads
+class RenderListener
+{
+
+public:
+
+	RenderListener() = default;
+
+	RenderListener(const RenderListener& other) = default;
+
+	RenderListener(RenderListener&& other) = default;
+
+	RenderListener& operator=(const RenderListener& other) = default;
+
+	RenderListener& operator=(RenderListener&& other) = default;
+
+	virtual ~RenderListener() = default;
+
+	//can be called by several render threads at the same time, the tile's pixels are already in the front image
+	virtual void onTileFinished(const Tile& tile) {}
+
+	virtual void onRefinementUpdated(int samples, double noise) {}
+
+	//called by the animation renderer, frames can finish out of order
+	virtual void onFrameFinished(int frame, int microseconds, bool saved) {}
+};
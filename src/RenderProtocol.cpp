@@ -0,0 +1,122 @@
+#include <arpa/inet.h>
+
+#include <cstring>
+
+#include "RenderProtocol.h"
+
+void RenderProtocol::writeInt(std::string& payload, int32_t value)
+{
+	uint32_t networkValue = htonl(static_cast<uint32_t>(value));
+	payload.append(reinterpret_cast<const char*>(&networkValue), sizeof(networkValue));
+}
+
+void RenderProtocol::writeFloat(std::string& payload, float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	writeInt(payload, static_cast<int32_t>(bits));
+}
+
+bool RenderProtocol::readInt(const std::string& payload, size_t& offset, int32_t& value)
+{
+	uint32_t networkValue;
+	if (offset + sizeof(networkValue) > payload.size())
+	{
+		return false;
+	}
+
+	std::memcpy(&networkValue, payload.data() + offset, sizeof(networkValue));
+	offset += sizeof(networkValue);
+	value = static_cast<int32_t>(ntohl(networkValue));
+
+	return true;
+}
+
+bool RenderProtocol::readFloat(const std::string& payload, size_t& offset, float& value)
+{
+	int32_t bits;
+	if (!readInt(payload, offset, bits))
+	{
+		return false;
+	}
+
+	std::memcpy(&value, &bits, sizeof(value));
+
+	return true;
+}
+
+std::string RenderProtocol::encodeTile(int id, const Tile& tile)
+{
+	std::string payload;
+
+	writeInt(payload, id);
+	writeInt(payload, tile.m_x);
+	writeInt(payload, tile.m_y);
+	writeInt(payload, tile.m_width);
+	writeInt(payload, tile.m_height);
+
+	return payload;
+}
+
+bool RenderProtocol::decodeTile(const std::string& payload, int& id, Tile& tile)
+{
+	size_t offset = 0;
+	int32_t values[5];
+
+	for (int32_t& value : values)
+	{
+		if (!readInt(payload, offset, value))
+		{
+			return false;
+		}
+	}
+
+	id = values[0];
+	tile = Tile{ values[1], values[2], values[3], values[4] };
+
+	return tile.m_width >= 0 && tile.m_height >= 0;
+}
+
+std::string RenderProtocol::encodeResult(int id, const Tile& tile, const std::vector<Color>& pixels)
+{
+	std::string payload = encodeTile(id, tile);
+	payload.reserve(payload.size() + pixels.size() * 3 * sizeof(float));
+
+	for (const Color& color : pixels)
+	{
+		writeFloat(payload, static_cast<float>(color.m_red));
+		writeFloat(payload, static_cast<float>(color.m_green));
+		writeFloat(payload, static_cast<float>(color.m_blue));
+	}
+
+	return payload;
+}
+
+bool RenderProtocol::decodeResult(const std::string& payload, int& id, Tile& tile, std::vector<Color>& pixels)
+{
+	if (!decodeTile(payload, id, tile))
+	{
+		return false;
+	}
+
+	size_t offset = 5 * sizeof(int32_t);
+	size_t pixelCount = static_cast<size_t>(tile.m_width) * tile.m_height;
+
+	if (payload.size() != offset + pixelCount * 3 * sizeof(float))
+	{
+		return false;
+	}
+
+	pixels.resize(pixelCount);
+
+	for (Color& color : pixels)
+	{
+		float red, green, blue;
+		readFloat(payload, offset, red);
+		readFloat(payload, offset, green);
+		readFloat(payload, offset, blue);
+		color = Color(red, green, blue);
+	}
+
+	return true;
+}
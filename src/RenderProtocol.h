@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Color.h"
+#include "TileScheduler.h"
+
+//messages exchanged between the render coordinator and its workers, all numbers are sent in network byte order
+//  HELLO    worker -> coordinator  version, thread count
+//  SCENE    coordinator -> worker  width, height, scene file contents
+//  TILE     coordinator -> worker  tile id, x, y, width, height
+//  RESULT   worker -> coordinator  tile id, x, y, width, height, rgb floats row by row
+//  SHUTDOWN coordinator -> worker  empty, also sent by a client to stop the render daemon
+//  JOB      client -> daemon       render job description
+//  JOB_RESULT daemon -> client     status, 0 on success, followed by the render log
+class RenderProtocol
+{
+public:
+
+	enum class MessageType : uint32_t
+	{
+		HELLO = 1,
+		SCENE,
+		TILE,
+		RESULT,
+		SHUTDOWN,
+		JOB,
+		JOB_RESULT
+	};
+
+	static constexpr int32_t VERSION = 1;
+
+	static void writeInt(std::string& payload, int32_t value);
+
+	static void writeFloat(std::string& payload, float value);
+
+	//return false if the payload is too short
+	static bool readInt(const std::string& payload, size_t& offset, int32_t& value);
+
+	static bool readFloat(const std::string& payload, size_t& offset, float& value);
+
+	static std::string encodeTile(int id, const Tile& tile);
+
+	static bool decodeTile(const std::string& payload, int& id, Tile& tile);
+
+	static std::string encodeResult(int id, const Tile& tile, const std::vector<Color>& pixels);
+
+	static bool decodeResult(const std::string& payload, int& id, Tile& tile, std::vector<Color>& pixels);
+};
@@ -0,0 +1,173 @@
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "CompiledScene.h"
+#include "RayTracer.h"
+#include "RenderProtocol.h"
+#include "RenderWorker.h"
+#include "Scene.h"
+#include "SettingsIO.h"
+#include "Socket.h"
+
+void RenderWorker::setThreadCount(int threadCount)
+{
+	m_threadCount = std::max(1, threadCount);
+}
+
+void RenderWorker::setConnectTimeout(int seconds)
+{
+	m_connectTimeout = seconds;
+}
+
+bool RenderWorker::run(const std::string& address)
+{
+	std::unique_ptr<Socket> socket;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while ((socket = Socket::connect(address)) == nullptr)
+	{
+		if (std::chrono::steady_clock::now() - start > std::chrono::seconds(m_connectTimeout))
+		{
+			return false;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	std::string hello;
+	RenderProtocol::writeInt(hello, RenderProtocol::VERSION);
+	RenderProtocol::writeInt(hello, m_threadCount);
+
+	uint32_t type;
+	std::string payload;
+
+	if (!socket->sendMessage(static_cast<uint32_t>(RenderProtocol::MessageType::HELLO), hello) 
+		|| !socket->receiveMessage(type, payload) 
+		|| type != static_cast<uint32_t>(RenderProtocol::MessageType::SCENE))
+	{
+		return false;
+	}
+
+	size_t offset = 0;
+	int32_t width = 0;
+	int32_t height = 0;
+
+	if (!RenderProtocol::readInt(payload, offset, width) || !RenderProtocol::readInt(payload, offset, height) || width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	Scene scene;
+	RayTracer rayTracer(width, height, &scene, scene.getCamera());
+
+	std::stringstream ss(payload.substr(offset));
+	SettingsIO::readSettings(ss, scene, rayTracer);
+
+	rayTracer.init(&scene, scene.getCamera());
+	rayTracer.setSize(width, height);
+	rayTracer.setPreviewMode(false);
+	rayTracer.setTemporalReprojection(false);
+
+	//compiled once for the whole job, so the render threads share its light tree and keep their occluder caches
+	CompiledScene compiledScene(scene);
+
+	//the connection is read here while the render threads take tiles from the queue and send their own results
+	std::deque<std::pair<int, Tile>> queue;
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	std::mutex sendMutex;
+	bool stopped = false;
+	bool failed = false;
+
+	auto renderTiles = [&]()
+	{
+		std::vector<Color> pixels;
+
+		while (true)
+		{
+			std::pair<int, Tile> job;
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				queueCondition.wait(lock, [&]() { return stopped || !queue.empty(); });
+
+				if (stopped)
+				{
+					return;
+				}
+
+				job = queue.front();
+				queue.pop_front();
+			}
+
+			if (!rayTracer.renderRegion(compiledScene, job.second, pixels))
+			{
+				return;
+			}
+
+			std::string result = RenderProtocol::encodeResult(job.first, job.second, pixels);
+
+			std::lock_guard<std::mutex> lock(sendMutex);
+			if (!socket->sendMessage(static_cast<uint32_t>(RenderProtocol::MessageType::RESULT), result))
+			{
+				rayTracer.cancelRendering();
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < m_threadCount; ++i)
+	{
+		threads.emplace_back(renderTiles);
+	}
+
+	int id;
+	Tile tile;
+
+	while (true)
+	{
+		if (!socket->receiveMessage(type, payload))
+		{
+			failed = true;
+			break;
+		}
+
+		if (type == static_cast<uint32_t>(RenderProtocol::MessageType::SHUTDOWN))
+		{
+			break;
+		}
+
+		if (type == static_cast<uint32_t>(RenderProtocol::MessageType::TILE))
+		{
+			//a tile that cannot be rendered closes the connection, so the coordinator issues it again instead of waiting for it
+			if (!RenderProtocol::decodeTile(payload, id, tile) 
+				|| tile.m_x < 0 || tile.m_y < 0 || tile.m_x + tile.m_width > width || tile.m_y + tile.m_height > height)
+			{
+				failed = true;
+				break;
+			}
+
+			std::lock_guard<std::mutex> lock(queueMutex);
+			queue.emplace_back(id, tile);
+			queueCondition.notify_one();
+		}
+	}
+
+	rayTracer.cancelRendering();
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopped = true;
+		queueCondition.notify_all();
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	return !failed;
+}
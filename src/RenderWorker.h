@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+//connects to a render coordinator, receives the scene once and renders the tiles it is sent until the coordinator shuts it down
+class RenderWorker
+{
+private:
+
+	int m_threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	int m_connectTimeout = 10;
+
+public:
+
+	RenderWorker() = default;
+
+	RenderWorker(const RenderWorker& other) = default;
+
+	RenderWorker(RenderWorker&& other) = default;
+
+	RenderWorker& operator=(const RenderWorker& other) = default;
+
+	RenderWorker& operator=(RenderWorker&& other) = default;
+
+	~RenderWorker() = default;
+
+	void setThreadCount(int threadCount);
+
+	//seconds to keep retrying while the coordinator is not listening yet
+	void setConnectTimeout(int seconds);
+
+	//returns false if the connection could not be made or broke before the shutdown message
+	bool run(const std::string& address);
+};
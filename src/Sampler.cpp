@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Sampler.h"
+#include "Constants.h"
+
+SamplePath SamplePath::child(int dimension, int index) const
+{
+	SamplePath path = *this;
+	path.m_depth++;
+	path.m_branch = Sampler::hash(m_branch ^ Sampler::hash(static_cast<uint32_t>(dimension) * 0x9E3779B9u + static_cast<uint32_t>(index) + 1u));
+
+	return path;
+}
+
+const Sampler& Sampler::get(SamplerType type)
+{
+	static const RandomSampler randomSampler;
+	static const StratifiedSampler stratifiedSampler;
+	static const HaltonSampler haltonSampler;
+	static const BlueNoiseSampler blueNoiseSampler;
+
+	switch (type)
+	{
+	case SamplerType::RANDOM:
+		return randomSampler;
+	case SamplerType::HALTON:
+		return haltonSampler;
+	case SamplerType::BLUE_NOISE:
+		return blueNoiseSampler;
+	default:
+		return stratifiedSampler;
+	}
+}
+
+uint32_t Sampler::hash(uint32_t value)
+{
+	value ^= value >> 16;
+	value *= 0x7FEB352Du;
+	value ^= value >> 15;
+	value *= 0x846CA68Bu;
+	value ^= value >> 16;
+
+	return value;
+}
+
+double Sampler::random(const SamplePath& path, int dimension, uint32_t salt)
+{
+	uint32_t seed = hash(static_cast<uint32_t>(path.m_x) * 0x8DA6B343u ^ static_cast<uint32_t>(path.m_y) * 0xD8163841u ^ static_cast<uint32_t>(path.m_pass) * 0xCB1AB31Fu);
+	seed = hash(seed ^ path.m_branch);
+	seed = hash(seed ^ (static_cast<uint32_t>(path.m_depth) << 16) ^ static_cast<uint32_t>(dimension));
+	seed = hash(seed ^ salt);
+
+	return seed / 4294967296.0;
+}
+
+void Sampler::toDisk(double u, double v, double& x, double& y)
+{
+	double a = 2.0 * u - 1.0;
+	double b = 2.0 * v - 1.0;
+
+	if (a == 0.0 && b == 0.0)
+	{
+		x = 0.0;
+		y = 0.0;
+		return;
+	}
+
+	double r;
+	double phi;
+
+	if (fabs(a) > fabs(b))
+	{
+		r = a;
+		phi = (Constants::PI / 4) * (b / a);
+	}
+	else
+	{
+		r = b;
+		phi = (Constants::PI / 2) - (Constants::PI / 4) * (a / b);
+	}
+
+	x = r * cos(phi);
+	y = r * sin(phi);
+}
+
+void Sampler::toDiskSegment(double nx, double ny, double offset, double& x, double& y)
+{
+	double along = x * nx + y * ny;
+	double acrossX = x - along * nx;
+	double acrossY = y - along * ny;
+
+	double squeezed = -offset + (along + 1.0) * (1.0 + offset) / 2.0;
+
+	//the chord through the squeezed point is shorter than the one through the original point
+	double chord = sqrt(std::max(0.0, 1.0 - along * along));
+	double scale = chord > 0.0 ? sqrt(std::max(0.0, 1.0 - squeezed * squeezed)) / chord : 0.0;
+
+	x = squeezed * nx + acrossX * scale;
+	y = squeezed * ny + acrossY * scale;
+}
+
+void RandomSampler::get2D(const SamplePath& path, int dimension, int index, int count, double& u, double& v) const
+{
+	u = random(path, dimension, 2 * index);
+	v = random(path, dimension, 2 * index + 1);
+}
+
+void StratifiedSampler::get2D(const SamplePath& path, int dimension, int index, int count, double& u, double& v) const
+{
+	int columns = std::max(1, static_cast<int>(ceil(sqrt(static_cast<double>(count)))));
+	int rows = (std::max(1, count) + columns - 1) / columns;
+	int cells = columns * rows;
+
+	//every path starts at a different cell, so paths with fewer points than cells still cover the square together
+	int offset = static_cast<int>(random(path, dimension, 0x80000000u) * cells);
+	int cell = (index + offset) % cells;
+
+	u = ((cell % columns) + random(path, dimension, 2 * index)) / columns;
+	v = ((cell / columns) + random(path, dimension, 2 * index + 1)) / rows;
+}
+
+double HaltonSampler::radicalInverse(uint32_t index, uint32_t base)
+{
+	double inverseBase = 1.0 / base;
+	double factor = inverseBase;
+	double result = 0.0;
+
+	while (index > 0)
+	{
+		result += (index % base) * factor;
+		index /= base;
+		factor *= inverseBase;
+	}
+
+	return result;
+}
+
+void HaltonSampler::get2D(const SamplePath& path, int dimension, int index, int count, double& u, double& v) const
+{
+	uint32_t sample = static_cast<uint32_t>(path.m_pass) * static_cast<uint32_t>(std::max(1, count)) + static_cast<uint32_t>(index) + 1u;
+
+	u = radicalInverse(sample, 2) + random(path, dimension, 0x80000000u);
+	v = radicalInverse(sample, 3) + random(path, dimension, 0x80000001u);
+
+	u -= floor(u);
+	v -= floor(v);
+}
+
+double BlueNoiseSampler::interleavedGradientNoise(double x, double y)
+{
+	double value = 52.9829189 * fmod(0.06711056 * x + 0.00583715 * y, 1.0);
+
+	return value - floor(value);
+}
+
+void BlueNoiseSampler::get2D(const SamplePath& path, int dimension, int index, int count, double& u, double& v) const
+{
+	//plastic constant steps spread consecutive points evenly in both axes
+	uint32_t sample = static_cast<uint32_t>(path.m_pass) * static_cast<uint32_t>(std::max(1, count)) + static_cast<uint32_t>(index);
+
+	//the noise pattern is moved by a different amount for every effect so they do not share offsets
+	double frame = static_cast<double>((hash(path.m_branch ^ (static_cast<uint32_t>(path.m_depth) << 16) ^ static_cast<uint32_t>(dimension)) & 63u));
+	double x = path.m_x + 5.588238 * frame;
+	double y = path.m_y + 5.588238 * frame;
+
+	u = 0.5 + sample * 0.7548776662466927 + interleavedGradientNoise(x, y);
+	v = 0.5 + sample * 0.5698402909980532 + interleavedGradientNoise(y + 31.0, x + 17.0);
+
+	u -= floor(u);
+	v -= floor(v);
+}
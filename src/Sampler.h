@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+
+//identifies the pixel, the refinement pass and the branch of the ray tree a distributed sample is taken for,
+//so every shading point gets its own decorrelated set of points no matter in which order the rays are traced
+struct SamplePath
+{
+	int m_x = 0;
+	int m_y = 0;
+	int m_pass = 0;
+	int m_depth = 0;
+	uint32_t m_branch = 0;
+
+	//path of the index-th ray spawned by the given effect at this point
+	SamplePath child(int dimension, int index) const;
+};
+
+//produces points in [0, 1)^2 for the shadow, reflection and refraction rays of one shading point,
+//implementations are stateless so a single instance is shared by all render threads
+class Sampler
+{
+public:
+
+	enum class SamplerType
+	{
+		RANDOM,
+		STRATIFIED,
+		HALTON,
+		BLUE_NOISE
+	};
+
+	Sampler() = default;
+
+	Sampler(const Sampler& other) = default;
+
+	Sampler(Sampler&& other) = default;
+
+	Sampler& operator=(const Sampler& other) = default;
+
+	Sampler& operator=(Sampler&& other) = default;
+
+	virtual ~Sampler() = default;
+
+	//index-th of count points of one effect, the dimension tells apart the effects of the same shading point
+	virtual void get2D(const SamplePath& path, int dimension, int index, int count, double& u, double& v) const = 0;
+
+	static const Sampler& get(SamplerType type);
+
+	static uint32_t hash(uint32_t value);
+
+	//uniform random number in [0, 1) derived from the path, dimension and salt
+	static double random(const SamplePath& path, int dimension, uint32_t salt);
+
+	//maps the unit square to the unit disk keeping the strata apart
+	static void toDisk(double u, double v, double& x, double& y);
+
+	//moves a point of the unit disk into the segment where x * nx + y * ny >= -offset, (nx, ny) has unit length and the offset is in [0, 1),
+	//the disk is squeezed along the normal and rescaled across it, so the map is one to one and keeps the strata apart
+	static void toDiskSegment(double nx, double ny, double offset, double& x, double& y);
+};
+
+//independent uniform points
+class RandomSampler : public Sampler
+{
+public:
+
+	void get2D(const SamplePath& path, int dimension, int index, int count, double& u, double& v) const override;
+};
+
+//one jittered point in every cell of a grid covering the square, every path starts at a random cell and walks the rest in order
+class StratifiedSampler : public Sampler
+{
+public:
+
+	void get2D(const SamplePath& path, int dimension, int index, int count, double& u, double& v) const override;
+};
+
+//Halton points in bases 2 and 3, shifted by a random offset per path and dimension,
+//refinement passes continue the sequence instead of repeating it
+class HaltonSampler : public Sampler
+{
+private:
+
+	static double radicalInverse(uint32_t index, uint32_t base);
+
+public:
+
+	void get2D(const SamplePath& path, int dimension, int index, int count, double& u, double& v) const override;
+};
+
+//R2 sequence shifted per pixel by interleaved gradient noise, neighbouring pixels get very different offsets
+//so the remaining error looks like fine grain instead of blotches
+class BlueNoiseSampler : public Sampler
+{
+private:
+
+	static double interleavedGradientNoise(double x, double y);
+
+public:
+
+	void get2D(const SamplePath& path, int dimension, int index, int count, double& u, double& v) const override;
+};
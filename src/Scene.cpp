@@ -129,6 +129,15 @@ Scene::Scene(const Scene& other)
 	{
 		m_shapes.push_back(shape->clone());
 	}
+
+	//the cloned shapes still point to the materials of the other scene
+	for (size_t i = 0; i < m_materials.size(); ++i)
+	{
+		for (const std::unique_ptr<ComponentShape>& shape : m_shapes)
+		{
+			changeMaterialInShape(shape.get(), other.m_materials[i].get(), m_materials[i].get());
+		}
+	}
 }
 
 Scene &Scene::operator=(const Scene& other)
@@ -168,6 +177,15 @@ Scene &Scene::operator=(const Scene& other)
 		m_shapes.push_back(shape->clone());
 	}
 
+	//the cloned shapes still point to the materials of the other scene
+	for (size_t i = 0; i < m_materials.size(); ++i)
+	{
+		for (const std::unique_ptr<ComponentShape>& shape : m_shapes)
+		{
+			changeMaterialInShape(shape.get(), other.m_materials[i].get(), m_materials[i].get());
+		}
+	}
+
 	return *this;
 }
 
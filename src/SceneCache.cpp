@@ -0,0 +1,100 @@
+#include "RayTracer.h"
+#include "SceneCache.h"
+#include "SettingsIO.h"
+
+SceneCache::SceneCache(size_t capacity)
+	: m_capacity(std::max<size_t>(1, capacity))
+{
+
+}
+
+std::shared_ptr<CachedScene> SceneCache::get(const std::string& fileName, bool& cached)
+{
+	cached = false;
+
+	std::error_code error;
+	std::string key = std::filesystem::weakly_canonical(fileName, error).string();
+	if (error)
+	{
+		key = fileName;
+	}
+
+	std::filesystem::file_time_type modificationTime = std::filesystem::last_write_time(key, error);
+	if (error)
+	{
+		return nullptr;
+	}
+
+	auto it = m_index.find(key);
+	if (it != m_index.end())
+	{
+		if (it->second->second->m_modificationTime == modificationTime)
+		{
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+			m_hits++;
+			cached = true;
+
+			return m_entries.front().second;
+		}
+
+		m_entries.erase(it->second);
+		m_index.erase(it);
+	}
+
+	m_misses++;
+
+	std::shared_ptr<CachedScene> entry = std::make_shared<CachedScene>();
+	RayTracer rayTracer;
+
+	if (!SettingsIO::loadSettings(key, entry->m_scene, rayTracer))
+	{
+		return nullptr;
+	}
+
+	entry->m_compiledScene = std::make_unique<CompiledScene>(entry->m_scene);
+	entry->m_rayTracerSettings = rayTracer.toDescription();
+	entry->m_modificationTime = modificationTime;
+
+	m_entries.emplace_front(key, entry);
+	m_index[key] = m_entries.begin();
+
+	while (m_entries.size() > m_capacity)
+	{
+		m_index.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+
+	return entry;
+}
+
+size_t SceneCache::getSize() const
+{
+	return m_entries.size();
+}
+
+int SceneCache::getHits() const
+{
+	return m_hits;
+}
+
+int SceneCache::getMisses() const
+{
+	return m_misses;
+}
+
+void SceneCache::setCapacity(size_t capacity)
+{
+	m_capacity = std::max<size_t>(1, capacity);
+
+	while (m_entries.size() > m_capacity)
+	{
+		m_index.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+}
+
+void SceneCache::clear()
+{
+	m_entries.clear();
+	m_index.clear();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "CompiledScene.h"
+#include "Scene.h"
+
+//a loaded scene together with the render settings that were saved with it, 
+//a cached scene is never changed, so it is compiled once and every job renders from that
+struct CachedScene
+{
+	Scene m_scene;
+	std::unique_ptr<CompiledScene> m_compiledScene;
+	std::string m_rayTracerSettings;
+	std::filesystem::file_time_type m_modificationTime;
+};
+
+//keeps the most recently used scenes loaded, a scene is loaded again when its file has changed
+class SceneCache
+{
+private:
+
+	size_t m_capacity = 8;
+	int m_hits = 0;
+	int m_misses = 0;
+
+	//most recently used first
+	std::list<std::pair<std::string, std::shared_ptr<CachedScene>>> m_entries;
+	std::unordered_map<std::string, std::list<std::pair<std::string, std::shared_ptr<CachedScene>>>::iterator> m_index;
+
+public:
+
+	SceneCache() = default;
+
+	explicit SceneCache(size_t capacity);
+
+	SceneCache(const SceneCache& other) = delete;
+
+	SceneCache(SceneCache&& other) = default;
+
+	SceneCache& operator=(const SceneCache& other) = delete;
+
+	SceneCache& operator=(SceneCache&& other) = default;
+
+	~SceneCache() = default;
+
+	//the returned scene stays valid even if it is evicted while it is in use, nullptr if it could not be loaded
+	std::shared_ptr<CachedScene> get(const std::string& fileName, bool& cached);
+
+	size_t getSize() const;
+
+	int getHits() const;
+
+	int getMisses() const;
+
+	void setCapacity(size_t capacity);
+
+	void clear();
+};
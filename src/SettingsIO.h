@@ -1,12 +1,21 @@
 #pragma once
 
+#include <istream>
+#include <ostream>
 #include <string>
 
+#include "Scene.h"
+#include "RayTracer.h"
+
 class SettingsIO
 {
 public:
 
-	static void saveSettings(const std::string& filename);
+	static void saveSettings(const std::string& filename, Scene& scene, const RayTracer& rayTracer);
+
+	static bool loadSettings(const std::string& filename, Scene& scene, RayTracer& rayTracer);
+
+	static void writeSettings(std::ostream& os, Scene& scene, const RayTracer& rayTracer);
 
-	static bool loadSettings(const std::string& filename);
+	static void readSettings(std::istream& is, Scene& scene, RayTracer& rayTracer);
 };
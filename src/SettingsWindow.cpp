@@ -5,6 +5,7 @@
 #include "PerspectiveCamera.h"
 #include "OrthoCamera.h"
 #include "Utility.h"
+#include "QtUtility.h"
 #include "Quadric.h"
 #include "CompositeShape.h"
 #include "ui_SettingsWindow.h"
@@ -108,6 +109,8 @@ void SettingsWindow::on_btnDeleteLight_clicked()
 
 	Application::m_scene.eraseLight(light);
 	loadLightItems();
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_lvLightsDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
@@ -140,6 +143,8 @@ void SettingsWindow::on_btnAddLight_clicked()
 
 	QModelIndex newIndex = m_lightListModel.index(m_lightListModel.rowCount() - 1, 0);
 	ui->lvLights->setCurrentIndex(newIndex);
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::loadSelectedLightSettings()
@@ -152,7 +157,7 @@ void SettingsWindow::loadSelectedLightSettings()
 	ui->lnLightName->setText(QString::fromStdString(light->getName()));
 	ui->lnLightName->setStyleSheet("color : #000000");
 	ui->lnLightName->setCursorPosition(0);
-	QColor color = QColor(Utility::colorToQColor(light->getColor()));
+	QColor color = QColor(QtUtility::colorToQColor(light->getColor()));
 	ui->btnLightColor->setStyleSheet("border: 1px solid black; background-color: " + color.name());
 	const Vector& position = light->getPosition();
 	ui->sbLightXPos->setValue(position.m_x);
@@ -189,11 +194,11 @@ void SettingsWindow::loadSelectedMaterialSettings()
 
 		const MaterialProperties& materialProperties = simpleMat->getProperties();
 
-		QColor diffColor = Utility::colorToQColor(materialProperties.m_diffuse);
+		QColor diffColor = QtUtility::colorToQColor(materialProperties.m_diffuse);
 		ui->btnMatColorDiffuse->setStyleSheet("border: 1px solid black; background-color: " + diffColor.name());
-		QColor specColor = Utility::colorToQColor(materialProperties.m_specular);
+		QColor specColor = QtUtility::colorToQColor(materialProperties.m_specular);
 		ui->btnMatColorSpecular->setStyleSheet("border: 1px solid black; background-color: " + specColor.name());
-		QColor ambColor = Utility::colorToQColor(materialProperties.m_ambient);
+		QColor ambColor = QtUtility::colorToQColor(materialProperties.m_ambient);
 		ui->btnMatColorAmbient->setStyleSheet("border: 1px solid black; background-color: " + ambColor.name());
 		ui->sbMatShininess->setValue(materialProperties.m_shininess);
 		ui->sbMatReflectance->setValue(materialProperties.m_reflectance);
@@ -254,11 +259,11 @@ void SettingsWindow::loadSelectedMaterialSettings()
 
 		const MaterialProperties& materialProperties1 = checkMat->getProperties1();
 
-		QColor diffColor = Utility::colorToQColor(materialProperties1.m_diffuse);
+		QColor diffColor = QtUtility::colorToQColor(materialProperties1.m_diffuse);
 		ui->btnMatColorDiffuse_2->setStyleSheet("border: 1px solid black; background-color: " + diffColor.name());
-		QColor specColor = Utility::colorToQColor(materialProperties1.m_specular);
+		QColor specColor = QtUtility::colorToQColor(materialProperties1.m_specular);
 		ui->btnMatColorSpecular_2->setStyleSheet("border: 1px solid black; background-color: " + specColor.name());
-		QColor ambColor = Utility::colorToQColor(materialProperties1.m_ambient);
+		QColor ambColor = QtUtility::colorToQColor(materialProperties1.m_ambient);
 		ui->btnMatColorAmbient_2->setStyleSheet("border: 1px solid black; background-color: " + ambColor.name());
 		ui->sbMatShininess_2->setValue(materialProperties1.m_shininess);
 		ui->sbMatReflectance_2->setValue(materialProperties1.m_reflectance);
@@ -269,11 +274,11 @@ void SettingsWindow::loadSelectedMaterialSettings()
 
 		const MaterialProperties& materialProperties2 = checkMat->getProperties2();
 
-		QColor diffColor2 = Utility::colorToQColor(materialProperties2.m_diffuse);
+		QColor diffColor2 = QtUtility::colorToQColor(materialProperties2.m_diffuse);
 		ui->btnMatColorDiffuse_3->setStyleSheet("border: 1px solid black; background-color: " + diffColor2.name());
-		QColor specColor2 = Utility::colorToQColor(materialProperties2.m_specular);
+		QColor specColor2 = QtUtility::colorToQColor(materialProperties2.m_specular);
 		ui->btnMatColorSpecular_3->setStyleSheet("border: 1px solid black; background-color: " + specColor2.name());
-		QColor ambColor2 = Utility::colorToQColor(materialProperties2.m_ambient);
+		QColor ambColor2 = QtUtility::colorToQColor(materialProperties2.m_ambient);
 		ui->btnMatColorAmbient_3->setStyleSheet("border: 1px solid black; background-color: " + ambColor2.name());
 		ui->sbMatShininess_3->setValue(materialProperties2.m_shininess);
 		ui->sbMatReflectance_3->setValue(materialProperties2.m_reflectance);
@@ -380,7 +385,9 @@ void SettingsWindow::loadSelectedShapeSettings()
 		Material* material = static_cast<Material*>(index.data(Qt::UserRole).value<void*>());
 		if (shapeMaterial == material)
 		{
+			ui->cbMat->blockSignals(true);
 			ui->cbMat->setCurrentIndex(i);
+			ui->cbMat->blockSignals(false);
 			break;
 		}
 	}
@@ -391,7 +398,7 @@ void SettingsWindow::loadSelectedShapeSettings()
 
 void SettingsWindow::saveRayTracerSettings()
 {
-	Application::m_rayTracer.setBackgroundColor(Utility::styleSheetToColor(ui->btnBackColor->styleSheet()));
+	Application::m_rayTracer.setBackgroundColor(QtUtility::styleSheetToColor(ui->btnBackColor->styleSheet()));
 	Application::m_rayTracer.setAdaptiveSuperSampling(ui->chkSuper->isChecked());
 	Application::m_rayTracer.setSuperSamplingThreshold(ui->sbTreshold->value());
 	Application::m_rayTracer.setSubSamplingSize(ui->sbSubsampling->value());
@@ -399,6 +406,30 @@ void SettingsWindow::saveRayTracerSettings()
 	Application::m_rayTracer.setShadowDist(ui->sbShadowCount->value());
 	Application::m_rayTracer.setReflectionDist(ui->sbReflectionCount->value());
 	Application::m_rayTracer.setRefractionDist(ui->sbRefractionCount->value());
+	Application::m_rayTracer.setProgressiveRefinement(ui->chkRefinement->isChecked());
+	Application::m_rayTracer.setRefinementNoiseThreshold(ui->sbRefinementThreshold->value());
+	Application::m_rayTracer.setRefinementMaxSamples(ui->sbRefinementMaxSamples->value());
+	Application::m_rayTracer.setRefinementUpdateInterval(ui->sbRefinementInterval->value());
+	Application::m_rayTracer.setTileOrder(static_cast<TileScheduler::TileOrder>(ui->cbTileOrder->currentIndex()));
+	Application::m_rayTracer.setTemporalReprojection(ui->chkReprojection->isChecked());
+	Application::m_rayTracer.setWavefront(ui->chkWavefront->isChecked());
+	Application::m_rayTracer.setSamplerType(static_cast<Sampler::SamplerType>(ui->cbSampler->currentIndex()));
+	Application::m_rayTracer.setAdaptiveShadows(ui->chkAdaptiveShadows->isChecked());
+	Application::m_rayTracer.setMinThroughput(ui->sbMinThroughput->value());
+	Application::m_rayTracer.setRussianRoulette(ui->chkRussianRoulette->isChecked());
+	Application::m_rayTracer.setLightThreshold(ui->sbLightThreshold->value());
+	Application::m_rayTracer.setLightSampleCount(ui->sbLightSamples->value());
+	Application::m_rayTracer.setOccluderCaching(ui->chkOccluderCache->isChecked());
+	Application::m_rayTracer.setFresnelSelection(ui->chkFresnelSelection->isChecked());
+	Application::m_rayTracer.setRayBudget(ui->sbRayBudget->value());
+	Application::m_rayTracer.setTileRayBudget(ui->sbTileRayBudget->value());
+	Application::m_rayTracer.setPreviewShadows(true);
+	Application::m_concurrencyHandler.getFrameTimeController().setEnabled(ui->chkDynamicResolution->isChecked());
+	Application::m_concurrencyHandler.getFrameTimeController().setTargetFrameTime(ui->sbFrameTime->value() * 1000);
+	Application::m_concurrencyHandler.getFrameTimeController().reset(ui->sbSubsampling->value());
+	Application::m_rayTracer.setPreviewSubSamplingSize(0);
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::saveCameraSettings()
@@ -431,6 +462,8 @@ void SettingsWindow::saveCameraSettings()
 	Application::m_rayTracer.init(&Application::m_scene, camera);
 	Application::m_keyEventHandler.init(camera);
 	Application::m_mouseEventHandler.init(camera);
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::saveSelectedLightSettings()
@@ -442,7 +475,7 @@ void SettingsWindow::saveSelectedLightSettings()
 		SphereLight* light = static_cast<SphereLight*>(index.data(Qt::UserRole).value<void*>());
 		light->setEnabled(ui->chkLightEnabled->isChecked());
 		light->setPosition(Vector(ui->sbLightXPos->value(), ui->sbLightYPos->value(), ui->sbLightZPos->value()));
-		light->setColor(Utility::styleSheetToColor(ui->btnLightColor->styleSheet()));
+		light->setColor(QtUtility::styleSheetToColor(ui->btnLightColor->styleSheet()));
 		light->setName(ui->lnLightName->text().trimmed().toStdString());
 		light->setRadius(ui->sbLightRadius->value());
 	}
@@ -451,9 +484,11 @@ void SettingsWindow::saveSelectedLightSettings()
 		PointLight* light = static_cast<PointLight*>(index.data(Qt::UserRole).value<void*>());
 		light->setEnabled(ui->chkLightEnabled->isChecked());
 		light->setPosition(Vector(ui->sbLightXPos->value(), ui->sbLightYPos->value(), ui->sbLightZPos->value()));
-		light->setColor(Utility::styleSheetToColor(ui->btnLightColor->styleSheet()));
+		light->setColor(QtUtility::styleSheetToColor(ui->btnLightColor->styleSheet()));
 		light->setName(ui->lnLightName->text().trimmed().toStdString());
 	}
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::saveSelectedMaterialSettings()
@@ -466,9 +501,9 @@ void SettingsWindow::saveSelectedMaterialSettings()
 
 		MaterialProperties materialProperties;
 
-		materialProperties.m_diffuse = Color(Utility::styleSheetToColor(ui->btnMatColorDiffuse->styleSheet()));
-		materialProperties.m_specular = Color(Utility::styleSheetToColor(ui->btnMatColorSpecular->styleSheet()));
-		materialProperties.m_ambient = Color(Utility::styleSheetToColor(ui->btnMatColorAmbient->styleSheet()));
+		materialProperties.m_diffuse = Color(QtUtility::styleSheetToColor(ui->btnMatColorDiffuse->styleSheet()));
+		materialProperties.m_specular = Color(QtUtility::styleSheetToColor(ui->btnMatColorSpecular->styleSheet()));
+		materialProperties.m_ambient = Color(QtUtility::styleSheetToColor(ui->btnMatColorAmbient->styleSheet()));
 		materialProperties.m_shininess = ui->sbMatShininess->value();
 		materialProperties.m_reflectance = ui->sbMatReflectance->value();
 		materialProperties.m_reflectionDistAngle = ui->sbMatReflectDistAngle->value();
@@ -485,9 +520,9 @@ void SettingsWindow::saveSelectedMaterialSettings()
 
 		MaterialProperties materialProperties1;
 
-		materialProperties1.m_diffuse = Color(Utility::styleSheetToColor(ui->btnMatColorDiffuse_2->styleSheet()));
-		materialProperties1.m_specular = Color(Utility::styleSheetToColor(ui->btnMatColorSpecular_2->styleSheet()));
-		materialProperties1.m_ambient = Color(Utility::styleSheetToColor(ui->btnMatColorAmbient_2->styleSheet()));
+		materialProperties1.m_diffuse = Color(QtUtility::styleSheetToColor(ui->btnMatColorDiffuse_2->styleSheet()));
+		materialProperties1.m_specular = Color(QtUtility::styleSheetToColor(ui->btnMatColorSpecular_2->styleSheet()));
+		materialProperties1.m_ambient = Color(QtUtility::styleSheetToColor(ui->btnMatColorAmbient_2->styleSheet()));
 		materialProperties1.m_shininess = ui->sbMatShininess_2->value();
 		materialProperties1.m_reflectance = ui->sbMatReflectance_2->value();
 		materialProperties1.m_reflectionDistAngle = ui->sbMatReflectDistAngle_2->value();
@@ -497,9 +532,9 @@ void SettingsWindow::saveSelectedMaterialSettings()
 
 		MaterialProperties materialProperties2;
 
-		materialProperties2.m_diffuse = Color(Utility::styleSheetToColor(ui->btnMatColorDiffuse_3->styleSheet()));
-		materialProperties2.m_specular = Color(Utility::styleSheetToColor(ui->btnMatColorSpecular_3->styleSheet()));
-		materialProperties2.m_ambient = Color(Utility::styleSheetToColor(ui->btnMatColorAmbient_3->styleSheet()));
+		materialProperties2.m_diffuse = Color(QtUtility::styleSheetToColor(ui->btnMatColorDiffuse_3->styleSheet()));
+		materialProperties2.m_specular = Color(QtUtility::styleSheetToColor(ui->btnMatColorSpecular_3->styleSheet()));
+		materialProperties2.m_ambient = Color(QtUtility::styleSheetToColor(ui->btnMatColorAmbient_3->styleSheet()));
 		materialProperties2.m_shininess = ui->sbMatShininess_3->value();
 		materialProperties2.m_reflectance = ui->sbMatReflectance_3->value();
 		materialProperties2.m_reflectionDistAngle = ui->sbMatReflectDistAngle_3->value();
@@ -511,6 +546,8 @@ void SettingsWindow::saveSelectedMaterialSettings()
 		material->setTileSize(Vector(ui->sbCheckerTileX->value(), ui->sbCheckerTileY->value(), ui->sbCheckerTileZ->value()));
 		material->setName(ui->lnMatName->text().toStdString());
 	}
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::saveSelectedShapeSettings()
@@ -576,6 +613,8 @@ void SettingsWindow::saveSelectedShapeSettings()
 		shape->setMaterial(material);
 		shape->setName(ui->lnShapeName->text().trimmed().toStdString());
 	}
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::saveSettings()
@@ -720,7 +759,7 @@ void SettingsWindow::selectShape(QTreeView* treeView, const QModelIndex& parentI
 
 void SettingsWindow::loadRayTracerSettings()
 {
-	QColor color = Utility::colorToQColor(Application::m_rayTracer.getBackgroundColor());
+	QColor color = QtUtility::colorToQColor(Application::m_rayTracer.getBackgroundColor());
 	ui->btnBackColor->setStyleSheet("border: 1px solid black; background-color: " + color.name());
 	ui->chkSuper->setChecked(Application::m_rayTracer.getAdaptiveSuperSampling());
 	ui->sbTreshold->setValue(Application::m_rayTracer.getSuperSamplingThreshold());
@@ -729,6 +768,25 @@ void SettingsWindow::loadRayTracerSettings()
 	ui->sbShadowCount->setValue(Application::m_rayTracer.getShadowDist());
 	ui->sbReflectionCount->setValue(Application::m_rayTracer.getReflectionDist());
 	ui->sbRefractionCount->setValue(Application::m_rayTracer.getRefractionDist());
+	ui->chkRefinement->setChecked(Application::m_rayTracer.getProgressiveRefinement());
+	ui->sbRefinementThreshold->setValue(Application::m_rayTracer.getRefinementNoiseThreshold());
+	ui->sbRefinementMaxSamples->setValue(Application::m_rayTracer.getRefinementMaxSamples());
+	ui->sbRefinementInterval->setValue(Application::m_rayTracer.getRefinementUpdateInterval());
+	ui->cbTileOrder->setCurrentIndex(static_cast<int>(Application::m_rayTracer.getTileOrder()));
+	ui->chkReprojection->setChecked(Application::m_rayTracer.getTemporalReprojection());
+	ui->chkWavefront->setChecked(Application::m_rayTracer.getWavefront());
+	ui->cbSampler->setCurrentIndex(static_cast<int>(Application::m_rayTracer.getSamplerType()));
+	ui->chkAdaptiveShadows->setChecked(Application::m_rayTracer.getAdaptiveShadows());
+	ui->sbMinThroughput->setValue(Application::m_rayTracer.getMinThroughput());
+	ui->chkRussianRoulette->setChecked(Application::m_rayTracer.getRussianRoulette());
+	ui->sbLightThreshold->setValue(Application::m_rayTracer.getLightThreshold());
+	ui->sbLightSamples->setValue(Application::m_rayTracer.getLightSampleCount());
+	ui->chkOccluderCache->setChecked(Application::m_rayTracer.getOccluderCaching());
+	ui->chkFresnelSelection->setChecked(Application::m_rayTracer.getFresnelSelection());
+	ui->sbRayBudget->setValue(Application::m_rayTracer.getRayBudget());
+	ui->sbTileRayBudget->setValue(Application::m_rayTracer.getTileRayBudget());
+	ui->chkDynamicResolution->setChecked(Application::m_concurrencyHandler.getFrameTimeController().isEnabled());
+	ui->sbFrameTime->setValue(Application::m_concurrencyHandler.getFrameTimeController().getTargetFrameTime() / 1000);
 }
 
 void SettingsWindow::loadCameraSettings()
@@ -797,6 +855,8 @@ void SettingsWindow::on_btnDeleteMat_clicked()
 
 	Application::m_scene.eraseMaterial(material);
 	loadMaterialItems();
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_currentMaterialChanged(const QModelIndex& current, const QModelIndex& previous)
@@ -851,11 +911,13 @@ void SettingsWindow::on_btnAddMat_clicked()
 
 	QModelIndex newIndex = m_materialListModel.index(m_materialListModel.rowCount() - 1, 0);
 	ui->lvMaterials->setCurrentIndex(newIndex);
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_btnLightColor_clicked()
 {
-	QColor initColor = Utility::styleSheetToQColor(ui->btnLightColor->styleSheet());
+	QColor initColor = QtUtility::styleSheetToQColor(ui->btnLightColor->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
 	if (color.isValid())
@@ -1055,6 +1117,8 @@ void SettingsWindow::on_cbMatType_currentIndexChanged(const QString& arg1)
 		matComboBoxItem->setData(QVariant::fromValue(static_cast<void*>(material)), Qt::UserRole);
 
 		loadSelectedMaterialSettings();
+
+		emit sceneChanged();
 	}
 	else if (ui->cbMatType->currentText() == "Checkerboard" && !dynamic_cast<CheckerMaterial*>(material))
 	{
@@ -1068,12 +1132,14 @@ void SettingsWindow::on_cbMatType_currentIndexChanged(const QString& arg1)
 		matComboBoxItem->setData(QVariant::fromValue(static_cast<void*>(material)), Qt::UserRole);
 
 		loadSelectedMaterialSettings();
+
+		emit sceneChanged();
 	}
 }
 
 void SettingsWindow::on_btnBackColor_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnBackColor->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnBackColor->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1085,7 +1151,7 @@ void SettingsWindow::on_btnBackColor_clicked()
 
 void SettingsWindow::on_btnMatColorDiffuse_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnMatColorDiffuse->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnMatColorDiffuse->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1098,7 +1164,7 @@ void SettingsWindow::on_btnMatColorDiffuse_clicked()
 
 void SettingsWindow::on_btnMatColorSpecular_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnMatColorSpecular->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnMatColorSpecular->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1111,7 +1177,7 @@ void SettingsWindow::on_btnMatColorSpecular_clicked()
 
 void SettingsWindow::on_btnMatColorAmbient_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnMatColorAmbient->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnMatColorAmbient->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1124,7 +1190,7 @@ void SettingsWindow::on_btnMatColorAmbient_clicked()
 
 void SettingsWindow::on_btnMatColorDiffuse_2_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnMatColorDiffuse_2->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnMatColorDiffuse_2->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1137,7 +1203,7 @@ void SettingsWindow::on_btnMatColorDiffuse_2_clicked()
 
 void SettingsWindow::on_btnMatColorSpecular_2_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnMatColorSpecular_2->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnMatColorSpecular_2->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1150,7 +1216,7 @@ void SettingsWindow::on_btnMatColorSpecular_2_clicked()
 
 void SettingsWindow::on_btnMatColorAmbient_2_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnMatColorAmbient_2->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnMatColorAmbient_2->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1163,7 +1229,7 @@ void SettingsWindow::on_btnMatColorAmbient_2_clicked()
 
 void SettingsWindow::on_btnMatColorDiffuse_3_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnMatColorDiffuse_3->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnMatColorDiffuse_3->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1176,7 +1242,7 @@ void SettingsWindow::on_btnMatColorDiffuse_3_clicked()
 
 void SettingsWindow::on_btnMatColorSpecular_3_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnMatColorSpecular_3->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnMatColorSpecular_3->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1189,7 +1255,7 @@ void SettingsWindow::on_btnMatColorSpecular_3_clicked()
 
 void SettingsWindow::on_btnMatColorAmbient_3_clicked()
 {
-    QColor initColor = Utility::styleSheetToQColor(ui->btnMatColorAmbient_3->styleSheet());
+    QColor initColor = QtUtility::styleSheetToQColor(ui->btnMatColorAmbient_3->styleSheet());
 	QColor color = QColorDialog::getColor(initColor, this, QString());
 
     if (color.isValid())
@@ -1265,6 +1331,101 @@ void SettingsWindow::on_sbRefractionCount_editingFinished()
 	saveRayTracerSettings();
 }
 
+void SettingsWindow::on_chkRefinement_clicked()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_sbRefinementThreshold_editingFinished()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_sbRefinementMaxSamples_editingFinished()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_sbRefinementInterval_editingFinished()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_cbTileOrder_activated(int index)
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_chkReprojection_clicked()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_chkDynamicResolution_clicked()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_chkWavefront_clicked()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_cbSampler_activated(int index)
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_chkAdaptiveShadows_clicked()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_sbMinThroughput_editingFinished()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_chkRussianRoulette_clicked()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_sbLightThreshold_editingFinished()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_sbLightSamples_editingFinished()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_chkOccluderCache_clicked()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_chkFresnelSelection_clicked()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_sbRayBudget_editingFinished()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_sbTileRayBudget_editingFinished()
+{
+	saveRayTracerSettings();
+}
+
+void SettingsWindow::on_sbFrameTime_editingFinished()
+{
+	saveRayTracerSettings();
+}
+
 void SettingsWindow::on_sbLightXPos_editingFinished()
 {
     saveSelectedLightSettings();
@@ -1398,6 +1559,8 @@ void SettingsWindow::on_btnDeleteShape_clicked()
 	Application::m_scene.eraseShape(shape);
 
 	loadShapeItems();
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_currentShapeChanged(const QModelIndex& current, const QModelIndex& previous)
@@ -1466,6 +1629,8 @@ void SettingsWindow::on_btnAddShape_clicked()
 
 	QModelIndex newIndex = m_shapeTreeModel.index(m_shapeTreeModel.rowCount() - 1, 0);
 	ui->tvShapes->setCurrentIndex(newIndex);
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_btnSetShape_clicked()
@@ -1660,6 +1825,8 @@ void SettingsWindow::on_cbShapeType_currentIndexChanged(const QString& arg1)
 		ui->cbShape->setCurrentText("Sphere");
 
 		loadSelectedShapeSettings();
+
+		emit sceneChanged();
 	}
 	else if (ui->cbShapeType->currentText() == "Plane" && !dynamic_cast<Plane*>(shape))
 	{
@@ -1675,6 +1842,8 @@ void SettingsWindow::on_cbShapeType_currentIndexChanged(const QString& arg1)
 		item->setData(QVariant::fromValue(static_cast<void*>(shape)), Qt::UserRole);
 
 		loadSelectedShapeSettings();
+
+		emit sceneChanged();
 	}
 	else if (ui->cbShapeType->currentText() == "Model" && !dynamic_cast<Model*>(shape))
 	{
@@ -1691,6 +1860,8 @@ void SettingsWindow::on_cbShapeType_currentIndexChanged(const QString& arg1)
 		item->setData(QVariant::fromValue(static_cast<void*>(shape)), Qt::UserRole);
 
 		loadSelectedShapeSettings();
+
+		emit sceneChanged();
 	}
 	else if (ui->cbShapeType->currentText() == "CSG object" && !dynamic_cast<CompositeShape*>(shape))
 	{
@@ -1707,6 +1878,8 @@ void SettingsWindow::on_cbShapeType_currentIndexChanged(const QString& arg1)
 		item->setData(QVariant::fromValue(static_cast<void*>(shape)), Qt::UserRole);
 
 		loadSelectedShapeSettings();
+
+		emit sceneChanged();
 	}
 }
 
@@ -1743,6 +1916,8 @@ void SettingsWindow::on_btnCreateComposite_clicked()
 	}
 	
     loadSelectedShapeSettings();
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_btnBreakComposite_clicked()
@@ -1768,6 +1943,8 @@ void SettingsWindow::on_btnBreakComposite_clicked()
 	Application::m_scene.eraseShape(shape);
 	
 	loadShapeItems();
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_btnCopyLight_clicked()
@@ -1783,6 +1960,8 @@ void SettingsWindow::on_btnCopyLight_clicked()
 	loadLightItems();
 
 	ui->lvLights->setCurrentIndex(m_lightListModel.index(m_lightListModel.rowCount() - 1, 0));
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_btnCopyMat_clicked()
@@ -1798,6 +1977,8 @@ void SettingsWindow::on_btnCopyMat_clicked()
 	loadMaterialItems();
 
 	ui->lvMaterials->setCurrentIndex(m_materialListModel.index(m_materialListModel.rowCount() - 1, 0));
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_btnCopyShape_clicked()
@@ -1823,6 +2004,8 @@ void SettingsWindow::on_btnCopyShape_clicked()
 	loadShapeItems();
 
 	ui->tvShapes->setCurrentIndex(m_shapeTreeModel.index(m_shapeTreeModel.rowCount() - 1, 0));
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_lnCompositeExpression_textEdited(const QString& arg1)
@@ -1993,6 +2176,8 @@ void SettingsWindow::on_btnTransApply_clicked()
 	shape->translate(Vector(ui->sbTransX->value(), ui->sbTransY->value(), ui->sbTransZ->value()));
 	
     loadSelectedShapeSettings();
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_btnRotApply_clicked()
@@ -2002,6 +2187,8 @@ void SettingsWindow::on_btnRotApply_clicked()
 	shape->rotate(ui->sbRotAmount->value(), Vector(ui->sbRotX->value(), ui->sbRotY->value(), ui->sbRotZ->value()));
 
 	loadSelectedShapeSettings();
+
+	emit sceneChanged();
 }
 
 void SettingsWindow::on_btnScaleApply_clicked()
@@ -2011,4 +2198,6 @@ void SettingsWindow::on_btnScaleApply_clicked()
 	shape->scale(Vector(ui->sbScaleX->value(), ui->sbScaleY->value(), ui->sbScaleZ->value()));
 
 	loadSelectedShapeSettings();
+
+	emit sceneChanged();
 }
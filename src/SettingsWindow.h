@@ -258,6 +258,48 @@ private slots:
 
     void on_sbRefractionCount_editingFinished();
 
+	void on_chkRefinement_clicked();
+
+	void on_sbRefinementThreshold_editingFinished();
+
+	void on_sbRefinementMaxSamples_editingFinished();
+
+	void on_sbRefinementInterval_editingFinished();
+
+	void on_cbTileOrder_activated(int index);
+
+	void on_chkReprojection_clicked();
+
+	void on_chkDynamicResolution_clicked();
+
+	void on_chkWavefront_clicked();
+
+	void on_cbSampler_activated(int index);
+
+	void on_chkAdaptiveShadows_clicked();
+
+	void on_sbMinThroughput_editingFinished();
+
+	void on_chkRussianRoulette_clicked();
+
+	void on_sbLightThreshold_editingFinished();
+
+	void on_sbLightSamples_editingFinished();
+
+	void on_chkOccluderCache_clicked();
+
+	void on_chkFresnelSelection_clicked();
+
+	void on_sbRayBudget_editingFinished();
+
+	void on_sbTileRayBudget_editingFinished();
+
+	void on_sbFrameTime_editingFinished();
+
+signals:
+
+	void sceneChanged();
+
 private:
 
     Ui::SettingsWindow* ui;
@@ -0,0 +1,326 @@
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "Socket.h"
+
+Socket::Socket(int descriptor)
+	: m_descriptor(descriptor)
+{
+
+}
+
+Socket::~Socket()
+{
+	close();
+}
+
+std::unique_ptr<Socket> Socket::listen(const std::string& address)
+{
+	std::unique_ptr<Socket> socket;
+
+	if (address.rfind("unix:", 0) == 0)
+	{
+		sockaddr_un unixAddress;
+		std::string path = address.substr(5);
+		if (!fillUnixAddress(path, unixAddress))
+		{
+			return nullptr;
+		}
+
+		int descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (descriptor < 0)
+		{
+			return nullptr;
+		}
+		socket.reset(new Socket(descriptor));
+
+		//a stale socket file from a crashed coordinator would make bind fail
+		::unlink(path.c_str());
+
+		if (::bind(descriptor, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) != 0)
+		{
+			return nullptr;
+		}
+		socket->m_unixPath = path;
+	}
+	else if (address.rfind("tcp:", 0) == 0)
+	{
+		std::string host;
+		std::string port;
+		if (!parseTcpAddress(address, host, port))
+		{
+			return nullptr;
+		}
+
+		addrinfo hints;
+		std::memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_flags = AI_PASSIVE;
+
+		addrinfo* result = nullptr;
+		if (::getaddrinfo(host == "*" ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0)
+		{
+			return nullptr;
+		}
+
+		for (addrinfo* info = result; info != nullptr && socket == nullptr; info = info->ai_next)
+		{
+			int descriptor = ::socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+			if (descriptor < 0)
+			{
+				continue;
+			}
+
+			int reuse = 1;
+			setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+			if (::bind(descriptor, info->ai_addr, info->ai_addrlen) == 0)
+			{
+				socket.reset(new Socket(descriptor));
+			}
+			else
+			{
+				::close(descriptor);
+			}
+		}
+
+		::freeaddrinfo(result);
+	}
+
+	if (socket == nullptr || ::listen(socket->m_descriptor, SOMAXCONN) != 0)
+	{
+		return nullptr;
+	}
+
+	return socket;
+}
+
+std::unique_ptr<Socket> Socket::connect(const std::string& address)
+{
+	if (address.rfind("unix:", 0) == 0)
+	{
+		sockaddr_un unixAddress;
+		if (!fillUnixAddress(address.substr(5), unixAddress))
+		{
+			return nullptr;
+		}
+
+		int descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (descriptor < 0)
+		{
+			return nullptr;
+		}
+		std::unique_ptr<Socket> socket(new Socket(descriptor));
+
+		if (::connect(descriptor, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) != 0)
+		{
+			return nullptr;
+		}
+
+		return socket;
+	}
+	else if (address.rfind("tcp:", 0) == 0)
+	{
+		std::string host;
+		std::string port;
+		if (!parseTcpAddress(address, host, port))
+		{
+			return nullptr;
+		}
+
+		addrinfo hints;
+		std::memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+
+		addrinfo* result = nullptr;
+		if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0)
+		{
+			return nullptr;
+		}
+
+		std::unique_ptr<Socket> socket;
+
+		for (addrinfo* info = result; info != nullptr && socket == nullptr; info = info->ai_next)
+		{
+			int descriptor = ::socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+			if (descriptor < 0)
+			{
+				continue;
+			}
+
+			if (::connect(descriptor, info->ai_addr, info->ai_addrlen) == 0)
+			{
+				setNoDelay(descriptor);
+				socket.reset(new Socket(descriptor));
+			}
+			else
+			{
+				::close(descriptor);
+			}
+		}
+
+		::freeaddrinfo(result);
+
+		return socket;
+	}
+
+	return nullptr;
+}
+
+std::unique_ptr<Socket> Socket::accept()
+{
+	int descriptor = ::accept(m_descriptor, nullptr, nullptr);
+	if (descriptor < 0)
+	{
+		return nullptr;
+	}
+
+	sockaddr_storage address;
+	socklen_t length = sizeof(address);
+	if (::getsockname(descriptor, reinterpret_cast<sockaddr*>(&address), &length) == 0 && address.ss_family != AF_UNIX)
+	{
+		setNoDelay(descriptor);
+	}
+
+	return std::unique_ptr<Socket>(new Socket(descriptor));
+}
+
+int Socket::getDescriptor() const
+{
+	return m_descriptor;
+}
+
+bool Socket::sendMessage(uint32_t type, const std::string& payload)
+{
+	if (payload.size() > MAX_MESSAGE_SIZE)
+	{
+		return false;
+	}
+
+	uint32_t header[2] = { htonl(type), htonl(static_cast<uint32_t>(payload.size())) };
+
+	return sendAll(reinterpret_cast<const char*>(header), sizeof(header)) && sendAll(payload.data(), payload.size());
+}
+
+bool Socket::receiveMessage(uint32_t& type, std::string& payload)
+{
+	uint32_t header[2];
+	if (!receiveAll(reinterpret_cast<char*>(header), sizeof(header)))
+	{
+		return false;
+	}
+
+	type = ntohl(header[0]);
+	uint32_t size = ntohl(header[1]);
+
+	if (size > MAX_MESSAGE_SIZE)
+	{
+		return false;
+	}
+
+	payload.resize(size);
+
+	return receiveAll(&payload[0], size);
+}
+
+void Socket::close()
+{
+	if (m_descriptor >= 0)
+	{
+		::close(m_descriptor);
+		m_descriptor = -1;
+	}
+
+	if (!m_unixPath.empty())
+	{
+		::unlink(m_unixPath.c_str());
+		m_unixPath.clear();
+	}
+}
+
+bool Socket::sendAll(const char* data, size_t size)
+{
+	while (size > 0)
+	{
+		//a lost peer has to show up as an error, not as SIGPIPE
+		ssize_t sent = ::send(m_descriptor, data, size, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (sent <= 0)
+		{
+			return false;
+		}
+
+		data += sent;
+		size -= sent;
+	}
+
+	return true;
+}
+
+bool Socket::receiveAll(char* data, size_t size)
+{
+	while (size > 0)
+	{
+		ssize_t received = ::recv(m_descriptor, data, size, 0);
+		if (received < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (received <= 0)
+		{
+			return false;
+		}
+
+		data += received;
+		size -= received;
+	}
+
+	return true;
+}
+
+bool Socket::parseTcpAddress(const std::string& address, std::string& host, std::string& port)
+{
+	size_t colon = address.find_last_of(':');
+	if (colon == std::string::npos || colon < 4)
+	{
+		return false;
+	}
+
+	host = address.substr(4, colon - 4);
+	port = address.substr(colon + 1);
+
+	return !host.empty() && !port.empty();
+}
+
+bool Socket::fillUnixAddress(const std::string& path, sockaddr_un& unixAddress)
+{
+	if (path.empty() || path.size() >= sizeof(unixAddress.sun_path))
+	{
+		return false;
+	}
+
+	std::memset(&unixAddress, 0, sizeof(unixAddress));
+	unixAddress.sun_family = AF_UNIX;
+	std::memcpy(unixAddress.sun_path, path.c_str(), path.size());
+
+	return true;
+}
+
+void Socket::setNoDelay(int descriptor)
+{
+	int flag = 1;
+	setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct sockaddr_un;
+
+//a stream socket that sends length prefixed messages, addresses are "unix:<path>" or "tcp:<host>:<port>"
+class Socket
+{
+private:
+
+	//messages larger than this are treated as a broken stream
+	static constexpr uint32_t MAX_MESSAGE_SIZE = 1u << 30;
+
+	int m_descriptor = -1;
+	std::string m_unixPath;
+
+	explicit Socket(int descriptor);
+
+	static bool parseTcpAddress(const std::string& address, std::string& host, std::string& port);
+
+	static bool fillUnixAddress(const std::string& path, sockaddr_un& unixAddress);
+
+	static void setNoDelay(int descriptor);
+
+	bool sendAll(const char* data, size_t size);
+
+	bool receiveAll(char* data, size_t size);
+
+public:
+
+	Socket() = default;
+
+	Socket(const Socket& other) = delete;
+
+	Socket(Socket&& other) = delete;
+
+	Socket& operator=(const Socket& other) = delete;
+
+	Socket& operator=(Socket&& other) = delete;
+
+	~Socket();
+
+	static std::unique_ptr<Socket> listen(const std::string& address);
+
+	static std::unique_ptr<Socket> connect(const std::string& address);
+
+	std::unique_ptr<Socket> accept();
+
+	int getDescriptor() const;
+
+	bool sendMessage(uint32_t type, const std::string& payload);
+
+	bool receiveMessage(uint32_t& type, std::string& payload);
+
+	void close();
+};
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cmath>
+
+#include "TileScheduler.h"
+#include "Constants.h"
+
+std::vector<Tile> TileScheduler::createTiles(int width, int height, int tileSize, TileOrder order, int roiX, int roiY)
+{
+	std::vector<Tile> tiles;
+
+	if (width <= 0 || height <= 0 || tileSize <= 0)
+	{
+		return tiles;
+	}
+
+	int columns = (width + tileSize - 1) / tileSize;
+	int rows = (height + tileSize - 1) / tileSize;
+
+	tiles.reserve(columns * rows);
+
+	for (int row = 0; row < rows; ++row)
+	{
+		for (int column = 0; column < columns; ++column)
+		{
+			int x = column * tileSize;
+			int y = row * tileSize;
+			tiles.push_back(Tile{ x, y, std::min(tileSize, width - x), std::min(tileSize, height - y) });
+		}
+	}
+
+	if (order == TileOrder::SCANLINE)
+	{
+		return tiles;
+	}
+
+	std::vector<double> keys(tiles.size());
+
+	if (order == TileOrder::SPIRAL)
+	{
+		//tiles are ordered by square rings around the center tile and by angle within a ring
+		double centerColumn = (columns - 1) / 2.0;
+		double centerRow = (rows - 1) / 2.0;
+
+		for (size_t i = 0; i < tiles.size(); ++i)
+		{
+			double dx = tiles[i].m_x / tileSize - centerColumn;
+			double dy = tiles[i].m_y / tileSize - centerRow;
+			double ring = std::max(fabs(dx), fabs(dy));
+			double angle = atan2(dy, dx) + Constants::PI;
+			keys[i] = ring * 8 * Constants::PI + angle;
+		}
+	}
+	else if (order == TileOrder::HILBERT)
+	{
+		int n = 1;
+		while (n < columns || n < rows)
+		{
+			n *= 2;
+		}
+
+		for (size_t i = 0; i < tiles.size(); ++i)
+		{
+			keys[i] = hilbertIndex(n, tiles[i].m_x / tileSize, tiles[i].m_y / tileSize);
+		}
+	}
+	else if (order == TileOrder::REGION_OF_INTEREST)
+	{
+		if (roiX < 0 || roiY < 0 || roiX >= width || roiY >= height)
+		{
+			roiX = width / 2;
+			roiY = height / 2;
+		}
+
+		for (size_t i = 0; i < tiles.size(); ++i)
+		{
+			double dx = tiles[i].m_x + tiles[i].m_width / 2.0 - roiX;
+			double dy = tiles[i].m_y + tiles[i].m_height / 2.0 - roiY;
+			keys[i] = dx * dx + dy * dy;
+		}
+	}
+
+	std::vector<size_t> indices(tiles.size());
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		indices[i] = i;
+	}
+
+	std::stable_sort(indices.begin(), indices.end(), [&keys](size_t a, size_t b)
+	{
+		return keys[a] < keys[b];
+	});
+
+	std::vector<Tile> orderedTiles;
+	orderedTiles.reserve(tiles.size());
+	for (size_t i : indices)
+	{
+		orderedTiles.push_back(tiles[i]);
+	}
+
+	return orderedTiles;
+}
+
+int TileScheduler::hilbertIndex(int n, int x, int y)
+{
+	int d = 0;
+
+	for (int s = n / 2; s > 0; s /= 2)
+	{
+		int rx = (x & s) > 0;
+		int ry = (y & s) > 0;
+		d += s * s * ((3 * rx) ^ ry);
+
+		//rotate the quadrant so the curve stays continuous
+		if (ry == 0)
+		{
+			if (rx == 1)
+			{
+				x = n - 1 - x;
+				y = n - 1 - y;
+			}
+			std::swap(x, y);
+		}
+	}
+
+	return d;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+struct Tile
+{
+	int m_x;
+	int m_y;
+	int m_width;
+	int m_height;
+};
+
+class TileScheduler
+{
+public:
+
+	enum class TileOrder
+	{
+		SCANLINE,
+		SPIRAL,
+		HILBERT,
+		REGION_OF_INTEREST
+	};
+
+	//splits the image into tiles of tileSize pixels and returns them in the order they should be rendered, 
+	//roiX and roiY are only used by REGION_OF_INTEREST, a negative value falls back to the image center
+	static std::vector<Tile> createTiles(int width, int height, int tileSize, TileOrder order, int roiX = -1, int roiY = -1);
+
+private:
+
+	static int hilbertIndex(int n, int x, int y);
+};
@@ -46,20 +46,3 @@ std::string& Utility::replace(std::string& str, const std::string& before, const
 	return str;
 }
 
-Color Utility::styleSheetToColor(const QString& styleSheet) 
-{
-	QStringRef name(&styleSheet, styleSheet.indexOf('#'), 7);
-	QColor color = QColor(name.toString());
-	return Color(color.red() / 255.0, color.green() / 255.0, color.blue() / 255.0);
-}
-
-QColor Utility::styleSheetToQColor(const QString& styleSheet) 
-{
-	QStringRef name(&styleSheet, styleSheet.indexOf('#'), 7);
-	return QColor(name.toString());
-}
-
-QColor Utility::colorToQColor(const Color& color) 
-{
-	return QColor(color.m_red * 255, color.m_green * 255, color.m_blue * 255);
-}
\ No newline at end of file
@@ -0,0 +1,611 @@
+#include <algorithm>
+#include <cmath>
+
+#include "WavefrontTracer.h"
+#include "RayTracer.h"
+
+WavefrontTracer::WavefrontTracer(const RayTracer& rayTracer, const CompiledScene& scene, const CancellationToken& cancellationToken, OccluderCache& occluderCache)
+	: m_scene(&scene)
+	, m_cancellationToken(&cancellationToken)
+	, m_sampler(&Sampler::get(rayTracer.getSamplerType()))
+	, m_backgroundColor(rayTracer.getBackgroundColor())
+	, m_previewMode(rayTracer.getPreviewMode())
+	, m_previewShadows(rayTracer.getPreviewShadows())
+	, m_shadowDist(rayTracer.getShadowDist())
+	, m_reflectionDist(rayTracer.getReflectionDist())
+	, m_refractionDist(rayTracer.getRefractionDist())
+	, m_raySorting(rayTracer.getRaySorting())
+	, m_adaptiveShadows(rayTracer.getAdaptiveShadows())
+	, m_minThroughput(rayTracer.getMinThroughput())
+	, m_russianRoulette(rayTracer.getRussianRoulette())
+	, m_fresnelSelection(rayTracer.getFresnelSelection())
+	, m_lightThreshold(rayTracer.getLightThreshold())
+	, m_lightSampleCount(rayTracer.getLightSampleCount())
+	, m_occluderCaching(rayTracer.getOccluderCaching())
+	, m_occluderCache(&occluderCache)
+{
+
+}
+
+bool WavefrontTracer::isCancelled() const
+{
+	return m_cancellationToken->isCancelled();
+}
+
+bool WavefrontTracer::trace(const std::vector<Ray>& rays, const std::vector<SamplePath>& paths, int recursion, double budget, std::vector<Color>& colors, std::vector<double>* hitDistances)
+{
+	colors.assign(rays.size(), Color(0.0, 0.0, 0.0));
+
+	if (hitDistances != nullptr)
+	{
+		hitDistances->assign(rays.size(), 0.0);
+	}
+
+	m_primaryRays.clear();
+	m_reflectionRays.clear();
+	m_refractionRays.clear();
+	m_shadowRays.clear();
+	m_shadowGroups.clear();
+	m_softShadowPoints = 0;
+	m_softShadowRays = 0;
+	m_cappedSamples = 0;
+	m_tracedRays = 0;
+	m_capped.assign(rays.size(), 0);
+
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		m_primaryRays.push_back({ rays[i], Color(1.0, 1.0, 1.0), static_cast<int>(i), recursion, paths[i], 1.0, budget });
+	}
+
+	if (!intersect(m_primaryRays))
+	{
+		return false;
+	}
+
+	shade(m_primaryRays, colors, hitDistances);
+
+	//the shading of every batch fills the queues of the next bounce
+	while (!m_shadowRays.empty() || !m_shadowGroups.empty() || !m_reflectionRays.empty() || !m_refractionRays.empty())
+	{
+		if (!occlude(colors) || !traceBatch(m_reflectionRays, colors) || !traceBatch(m_refractionRays, colors))
+		{
+			return false;
+		}
+	}
+
+	m_cappedSamples = std::count(m_capped.begin(), m_capped.end(), 1);
+
+	return !isCancelled();
+}
+
+int64_t WavefrontTracer::getSoftShadowPoints() const
+{
+	return m_softShadowPoints;
+}
+
+int64_t WavefrontTracer::getSoftShadowRays() const
+{
+	return m_softShadowRays;
+}
+
+int64_t WavefrontTracer::getCappedSamples() const
+{
+	return m_cappedSamples;
+}
+
+int64_t WavefrontTracer::getTracedRays() const
+{
+	return m_tracedRays;
+}
+
+bool WavefrontTracer::traceBatch(std::vector<QueuedRay>& queue, std::vector<Color>& colors)
+{
+	if (queue.empty())
+	{
+		return true;
+	}
+
+	//the newest rays are the deepest ones, finishing them first keeps distributed rays from 
+	//multiplying the queue with every bounce
+	size_t batchSize = std::min(queue.size(), static_cast<size_t>(BATCH_SIZE));
+	m_activeRays.assign(queue.end() - batchSize, queue.end());
+	queue.resize(queue.size() - batchSize);
+
+	sortRays(m_activeRays);
+
+	if (!intersect(m_activeRays))
+	{
+		return false;
+	}
+
+	shade(m_activeRays, colors, nullptr);
+
+	return true;
+}
+
+uint32_t WavefrontTracer::expandBits(uint32_t value)
+{
+	value = (value * 0x00010001u) & 0xFF0000FFu;
+	value = (value * 0x00000101u) & 0x0F00F00Fu;
+	value = (value * 0x00000011u) & 0xC30C30C3u;
+	value = (value * 0x00000005u) & 0x49249249u;
+
+	return value;
+}
+
+void WavefrontTracer::sortRays(std::vector<QueuedRay>& rays)
+{
+	if (m_raySorting == false || rays.size() < 2 || rays.size() > BATCH_SIZE)
+	{
+		return;
+	}
+
+	Vector minimum = rays[0].m_ray.getOrigin();
+	Vector maximum = minimum;
+
+	for (const QueuedRay& queuedRay : rays)
+	{
+		const Vector& origin = queuedRay.m_ray.getOrigin();
+		minimum = Vector(std::min(minimum.m_x, origin.m_x), std::min(minimum.m_y, origin.m_y), std::min(minimum.m_z, origin.m_z));
+		maximum = Vector(std::max(maximum.m_x, origin.m_x), std::max(maximum.m_y, origin.m_y), std::max(maximum.m_z, origin.m_z));
+	}
+
+	const double cells = (1 << MORTON_BITS) - 1;
+	Vector extent = maximum - minimum;
+	Vector scale(extent.m_x > 0.0 ? cells / extent.m_x : 0.0, extent.m_y > 0.0 ? cells / extent.m_y : 0.0, extent.m_z > 0.0 ? cells / extent.m_z : 0.0);
+
+	m_sortKeys.clear();
+
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		const Vector& origin = rays[i].m_ray.getOrigin();
+		const Vector& direction = rays[i].m_ray.getDirection();
+
+		uint32_t x = static_cast<uint32_t>((origin.m_x - minimum.m_x) * scale.m_x);
+		uint32_t y = static_cast<uint32_t>((origin.m_y - minimum.m_y) * scale.m_y);
+		uint32_t z = static_cast<uint32_t>((origin.m_z - minimum.m_z) * scale.m_z);
+		uint64_t morton = (expandBits(x) << 2) | (expandBits(y) << 1) | expandBits(z);
+
+		uint64_t octant = (direction.m_x < 0 ? 4 : 0) | (direction.m_y < 0 ? 2 : 0) | (direction.m_z < 0 ? 1 : 0);
+
+		//the index fits below the code, so plain integers are sorted instead of the rays
+		m_sortKeys.push_back((((octant << (3 * MORTON_BITS)) | morton) << BATCH_BITS) | i);
+	}
+
+	std::sort(m_sortKeys.begin(), m_sortKeys.end());
+
+	m_sortedRays.clear();
+
+	for (uint64_t key : m_sortKeys)
+	{
+		m_sortedRays.push_back(rays[key & (BATCH_SIZE - 1)]);
+	}
+
+	std::swap(rays, m_sortedRays);
+}
+
+bool WavefrontTracer::intersect(const std::vector<QueuedRay>& rays)
+{
+	m_intersections.assign(rays.size(), Intersection(0.0));
+	m_tracedRays += static_cast<int64_t>(rays.size());
+
+	for (const ComponentShape* shape : m_scene->getShapes())
+	{
+		if (isCancelled())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < rays.size(); ++i)
+		{
+			Intersection intersection = shape->getIntersection(rays[i].m_ray);
+
+			if (intersection.m_t > 0.0 && intersection.m_material != nullptr && (m_intersections[i].m_t == 0.0 || intersection.m_t < m_intersections[i].m_t))
+			{
+				m_intersections[i] = intersection;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool WavefrontTracer::occlude(std::vector<Color>& colors)
+{
+	m_occluded.assign(m_shadowRays.size(), 0);
+	m_cachedOccluders.assign(m_shadowRays.size(), nullptr);
+	m_tracedRays += static_cast<int64_t>(m_shadowRays.size());
+
+	int64_t hits = 0;
+
+	//every ray first tries the shape that blocked the last ray towards its light
+	if (m_occluderCaching == true)
+	{
+		m_occluderCache->prepare(*m_scene);
+
+		for (size_t i = 0; i < m_shadowRays.size(); ++i)
+		{
+			const ComponentShape* cached = m_occluderCache->getOccluder(m_shadowRays[i].m_light);
+			m_cachedOccluders[i] = cached;
+
+			if (cached != nullptr && OccluderCache::occludes(cached, m_shadowRays[i].m_ray))
+			{
+				m_occluded[i] = 1;
+				hits++;
+			}
+		}
+	}
+
+	for (const ComponentShape* shape : m_scene->getShapes())
+	{
+		if (isCancelled())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < m_shadowRays.size(); ++i)
+		{
+			if (m_occluded[i] || shape == m_cachedOccluders[i])
+			{
+				continue;
+			}
+
+			if (OccluderCache::occludes(shape, m_shadowRays[i].m_ray))
+			{
+				m_occluded[i] = 1;
+
+				if (m_occluderCaching == true)
+				{
+					m_occluderCache->setOccluder(m_shadowRays[i].m_light, shape);
+				}
+			}
+		}
+	}
+
+	if (m_occluderCaching == true)
+	{
+		m_occluderCache->count(static_cast<int64_t>(m_shadowRays.size()), hits, std::count(m_occluded.begin(), m_occluded.end(), 1));
+	}
+
+	for (size_t i = 0; i < m_shadowRays.size(); ++i)
+	{
+		if (m_occluded[i])
+		{
+			continue;
+		}
+
+		if (m_shadowRays[i].m_group >= 0)
+		{
+			ShadowGroup& group = m_shadowGroups[m_shadowRays[i].m_group];
+			group.m_colorSum += m_shadowRays[i].m_contribution;
+			group.m_litCount++;
+		}
+		else
+		{
+			colors[m_shadowRays[i].m_pixel] += m_shadowRays[i].m_contribution;
+		}
+	}
+
+	m_shadowRays.clear();
+
+	resolveShadowGroups(colors);
+
+	return true;
+}
+
+void WavefrontTracer::resolveShadowGroups(std::vector<Color>& colors)
+{
+	//every group still waiting has all of its queued rays traced by now
+	size_t waiting = 0;
+
+	for (size_t g = 0; g < m_shadowGroups.size(); ++g)
+	{
+		ShadowGroup& group = m_shadowGroups[g];
+
+		if (group.m_sampleCount < group.m_shadowRayCount && group.m_litCount > 0 && group.m_litCount < group.m_sampleCount)
+		{
+			m_shadowGroups[waiting] = group;
+			queueShadowRays(static_cast<int>(waiting), group.m_sampleCount, group.m_shadowRayCount);
+			waiting++;
+			continue;
+		}
+
+		colors[group.m_pixel] += group.m_weight * group.m_colorSum / group.m_sampleCount;
+	}
+
+	m_shadowGroups.resize(waiting);
+}
+
+void WavefrontTracer::queueShadowRays(int group, int first, int last)
+{
+	ShadowGroup& shadowGroup = m_shadowGroups[group];
+	const CompiledScene::CompiledLight& light = m_scene->getLights()[shadowGroup.m_light];
+
+	for (int j = first; j < last; ++j)
+	{
+		double u;
+		double v;
+		RayTracer::getShadowSample(*m_sampler, shadowGroup.m_path, shadowGroup.m_light, j, RayTracer::SHADOW_PROBE_RAYS, shadowGroup.m_shadowRayCount, u, v);
+
+		Ray shadowRay = light.m_light->getShadowRay(shadowGroup.m_point, shadowGroup.m_lightBasis, u, v);
+		shadowRay.shiftOrigin();
+
+		if (dot(shadowRay.getDirection(), shadowGroup.m_normal) < 0)
+		{
+			continue;
+		}
+
+		Vector lightDir = shadowRay.getDirection();
+		lightDir.normalize();
+
+		Color contribution = getLightContribution(light.m_color, lightDir, shadowGroup.m_normal, shadowGroup.m_viewDir, *shadowGroup.m_materialProperties);
+		m_shadowRays.push_back({ shadowRay, contribution, shadowGroup.m_pixel, group, shadowGroup.m_light });
+		m_softShadowRays++;
+	}
+
+	shadowGroup.m_sampleCount = last;
+}
+
+Color WavefrontTracer::getLightContribution(const Color& lightColor, const Vector& lightDir, const Vector& normal, const Vector& viewDir, const MaterialProperties& materialProperties)
+{
+	//diffuse
+	Color contribution = lightColor * (fabs(dot(lightDir, normal)) * materialProperties.m_diffuse);
+
+	//specular
+	if (materialProperties.m_shininess != 0)
+	{
+		Vector reflectionDir = reflect(-lightDir, normal);
+		double specular = dot(viewDir, reflectionDir);
+		if (specular > 0)
+		{
+			contribution += lightColor * pow(specular, materialProperties.m_shininess) * materialProperties.m_specular;
+		}
+	}
+
+	return contribution;
+}
+
+void WavefrontTracer::shade(const std::vector<QueuedRay>& rays, std::vector<Color>& colors, std::vector<double>* hitDistances)
+{
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		const Intersection& intersection = m_intersections[i];
+
+		if (intersection.type == Intersection::IntersectionType::NONE || intersection.m_material == nullptr)
+		{
+			colors[rays[i].m_pixel] += rays[i].m_weight * m_backgroundColor;
+			continue;
+		}
+
+		if (hitDistances != nullptr)
+		{
+			(*hitDistances)[rays[i].m_pixel] = intersection.m_t;
+		}
+
+		shadeHit(rays[i], intersection, colors);
+	}
+}
+
+void WavefrontTracer::shadeHit(const QueuedRay& queuedRay, const Intersection& intersection, std::vector<Color>& colors)
+{
+	const Ray& ray = queuedRay.m_ray;
+	const Color& weight = queuedRay.m_weight;
+	const SamplePath& path = queuedRay.m_path;
+
+	Vector point = ray.getPoint(intersection.m_t);
+	const Vector& normal = intersection.m_normal;
+
+	const MaterialProperties& materialProperties = intersection.m_material->getProperties(point);
+
+	//ambient
+	colors[queuedRay.m_pixel] += weight * materialProperties.m_ambient;
+
+	//lights, the light is computed up front and only added if the shadow ray gets through
+	bool shadows = m_previewMode == false || m_previewShadows == true;
+
+	const std::vector<CompiledScene::CompiledLight>& lights = m_scene->getLights();
+	const int reflectionDimension = static_cast<int>(lights.size());
+	const int refractionDimension = reflectionDimension + 1;
+
+	Vector viewDir = -ray.getDirection();
+	viewDir.normalize();
+
+	RayTracer::selectLights(m_scene->getLightTree(), *m_sampler, path, point, normal, materialProperties, m_lightThreshold, m_lightSampleCount, m_selectedLights);
+
+	double reflectance = materialProperties.m_reflectance;
+	double transparency = materialProperties.m_transparency;
+
+	if (m_fresnelSelection == true && m_previewMode == false && transparency > 0 && queuedRay.m_recursion > 0)
+	{
+		RayTracer::selectFresnelBranch(path, ray.getDirection(), normal, intersection.m_material->getProperties().m_refractionIndex,
+			intersection.type == Intersection::IntersectionType::OUT, reflectance, transparency);
+	}
+
+	int shadowDist = m_previewMode == false ? m_shadowDist : 1;
+	int reflectionCount = m_previewMode == false && reflectance > 0 && queuedRay.m_recursion > 0 ? m_reflectionDist : 0;
+	int refractionCount = m_previewMode == false && transparency > 0 && queuedRay.m_recursion > 0 ? m_refractionDist : 0;
+	double reflectionBudget = queuedRay.m_budget;
+	double refractionBudget = queuedRay.m_budget;
+
+	if (std::isfinite(queuedRay.m_budget))
+	{
+		int softLightCount = 0;
+
+		for (const LightTree::LightSample& selectedLight : m_selectedLights)
+		{
+			if (lights[selectedLight.m_light].m_type == CompiledScene::LightType::SPHERE)
+			{
+				softLightCount++;
+			}
+		}
+
+		if (RayTracer::splitRayBudget(queuedRay.m_budget, static_cast<int>(m_selectedLights.size()), softLightCount, shadowDist, 
+			reflectionCount, reflectionBudget, refractionCount, refractionBudget))
+		{
+			m_capped[queuedRay.m_pixel] = 1;
+		}
+	}
+
+	for (const LightTree::LightSample& selectedLight : m_selectedLights)
+	{
+		const int l = selectedLight.m_light;
+		const CompiledScene::CompiledLight& light = lights[l];
+		const Color& lightColor = light.m_color;
+
+		int shadowRayCount = 1;
+
+		if (light.m_type == CompiledScene::LightType::SPHERE && shadowDist > 1)
+		{
+			shadowRayCount = shadowDist;
+			m_softShadowPoints++;
+		}
+
+		//the rest of the budget depends on what the probe rays find, so the point waits in a group until they are traced
+		if (m_adaptiveShadows == true && shadowRayCount > RayTracer::SHADOW_PROBE_RAYS)
+		{
+			ShadowGroup group;
+			group.m_point = point;
+			group.m_normal = normal;
+			group.m_viewDir = viewDir;
+			group.m_lightBasis = OrthonormalBasis(light.m_light->getPosition() - point);
+			group.m_materialProperties = &materialProperties;
+			group.m_weight = weight * selectedLight.m_weight;
+			group.m_path = path;
+			group.m_light = l;
+			group.m_pixel = queuedRay.m_pixel;
+			group.m_shadowRayCount = shadowRayCount;
+
+			m_shadowGroups.push_back(group);
+			queueShadowRays(static_cast<int>(m_shadowGroups.size()) - 1, 0, RayTracer::SHADOW_PROBE_RAYS);
+			continue;
+		}
+
+		OrthonormalBasis lightBasis;
+		if (shadowRayCount > 1)
+		{
+			lightBasis = OrthonormalBasis(light.m_light->getPosition() - point);
+		}
+
+		for (int j = 0; j < shadowRayCount; ++j)
+		{
+			Ray shadowRay;
+
+			if (shadowRayCount > 1)
+			{
+				double u;
+				double v;
+				m_sampler->get2D(path, l, j, shadowRayCount, u, v);
+				shadowRay = light.m_light->getShadowRay(point, lightBasis, u, v);
+			}
+			else
+			{
+				shadowRay = light.m_light->getShadowRay(point, false);
+			}
+
+			shadowRay.shiftOrigin();
+
+			if (dot(shadowRay.getDirection(), normal) < 0)
+			{
+				continue;
+			}
+
+			Vector lightDir = shadowRay.getDirection();
+			lightDir.normalize();
+
+			Color contribution = weight * getLightContribution(lightColor, lightDir, normal, viewDir, materialProperties) * (selectedLight.m_weight / shadowRayCount);
+
+			if (shadows)
+			{
+				if (shadowRayCount > 1)
+				{
+					m_softShadowRays++;
+				}
+
+				m_shadowRays.push_back({ shadowRay, contribution, queuedRay.m_pixel, -1, l });
+			}
+			else
+			{
+				colors[queuedRay.m_pixel] += contribution;
+			}
+		}
+	}
+
+	//reflected ray
+	if (reflectionCount > 0)
+	{
+		Ray reflectedRay = ray.reflect(point, normal);
+		reflectedRay.shiftOrigin();
+
+		double reflectedThroughput = queuedRay.m_throughput * reflectance;
+
+		if (m_reflectionDist == 1)
+		{
+			queueRay(m_reflectionRays, reflectedRay, weight * reflectance, queuedRay, path.child(reflectionDimension, 0), reflectedThroughput, reflectionBudget);
+		}
+		else
+		{
+			Color distWeight = weight * reflectance / reflectionCount;
+
+			OrthonormalBasis reflectionBasis(reflectedRay.getDirection());
+			double reflectionRadius = Ray::getConeRadius(materialProperties.m_reflectionDistAngle);
+			Vector reflectionSide = dot(reflectedRay.getDirection(), normal) >= 0 ? normal : -normal;
+
+			for (int i = 0; i < reflectionCount; ++i)
+			{
+				double u;
+				double v;
+				m_sampler->get2D(path, reflectionDimension, i, reflectionCount, u, v);
+				Ray distRay = reflectedRay.distribute(reflectionBasis, reflectionRadius, reflectionSide, u, v);
+				queueRay(m_reflectionRays, distRay, distWeight, queuedRay, path.child(reflectionDimension, i), reflectedThroughput, reflectionBudget);
+			}
+		}
+	}
+
+	//refracted ray
+	if (refractionCount > 0)
+	{
+		double n2 = intersection.m_material->getProperties().m_refractionIndex;
+		Ray refractedRay = ray.refract(point, normal, n2, intersection.type == Intersection::IntersectionType::OUT);
+
+		const Vector& direction = refractedRay.getDirection();
+
+		if (direction.m_x != 0 || direction.m_y != 0 || direction.m_z != 0)
+		{
+			refractedRay.shiftOrigin();
+
+			double refractedThroughput = queuedRay.m_throughput * transparency;
+
+			if (m_refractionDist == 1)
+			{
+				queueRay(m_refractionRays, refractedRay, weight * transparency, queuedRay, path.child(refractionDimension, 0), refractedThroughput, refractionBudget);
+			}
+			else
+			{
+				Color distWeight = weight * transparency / refractionCount;
+
+				OrthonormalBasis refractionBasis(refractedRay.getDirection());
+				double refractionRadius = Ray::getConeRadius(materialProperties.m_refractionDistAngle);
+				Vector refractionSide = dot(refractedRay.getDirection(), normal) >= 0 ? normal : -normal;
+
+				for (int i = 0; i < refractionCount; ++i)
+				{
+					double u;
+					double v;
+					m_sampler->get2D(path, refractionDimension, i, refractionCount, u, v);
+					Ray distRay = refractedRay.distribute(refractionBasis, refractionRadius, refractionSide, u, v);
+					queueRay(m_refractionRays, distRay, distWeight, queuedRay, path.child(refractionDimension, i), refractedThroughput, refractionBudget);
+				}
+			}
+		}
+	}
+}
+
+void WavefrontTracer::queueRay(std::vector<QueuedRay>& queue, const Ray& ray, const Color& weight, const QueuedRay& parent, const SamplePath& path, double throughput, double budget)
+{
+	double survival = RayTracer::getSurvivalProbability(path, throughput, m_minThroughput, m_russianRoulette);
+
+	if (survival > 0.0)
+	{
+		queue.push_back({ ray, weight / survival, parent.m_pixel, parent.m_recursion - 1, path, throughput / survival, budget });
+	}
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "Color.h"
+#include "CompiledScene.h"
+#include "Intersection.h"
+#include "OccluderCache.h"
+#include "Ray.h"
+#include "Sampler.h"
+
+class RayTracer;
+
+//traces a batch of rays breadth first instead of recursing per pixel: primary, shadow, reflection and refraction rays
+//wait in their own queues, every queue is intersected against the scene in bulk and the hits are shaded in bulk
+class WavefrontTracer
+{
+private:
+
+	//a ray waiting to be traced, whatever it hits is added to its pixel scaled by the weight
+	struct QueuedRay
+	{
+		Ray m_ray;
+		Color m_weight;
+		int m_pixel = 0;
+		int m_recursion = 0;
+		SamplePath m_path;
+		double m_throughput = 1.0;
+		double m_budget = 0.0;
+	};
+
+	//the light a shadow ray carries reaches its pixel if nothing is in the way, 
+	//or is collected by its group if it belongs to an adaptively sampled point
+	struct ShadowRay
+	{
+		Ray m_ray;
+		Color m_contribution;
+		int m_pixel = 0;
+		int m_group = -1;
+		int m_light = 0;
+	};
+
+	//a shading point lit by a soft shadowed light, it waits for its probe rays before the rest of the budget is queued
+	struct ShadowGroup
+	{
+		Vector m_point;
+		Vector m_normal;
+		Vector m_viewDir;
+		OrthonormalBasis m_lightBasis;
+		const MaterialProperties* m_materialProperties = nullptr;
+		Color m_weight;
+		SamplePath m_path;
+		int m_light = 0;
+		int m_pixel = 0;
+		int m_shadowRayCount = 0;
+		int m_sampleCount = 0;
+		int m_litCount = 0;
+		Color m_colorSum;
+	};
+
+	const CompiledScene* m_scene = nullptr;
+	const CancellationToken* m_cancellationToken = nullptr;
+	const Sampler* m_sampler = nullptr;
+	Color m_backgroundColor;
+	bool m_previewMode = false;
+	bool m_previewShadows = true;
+	int m_shadowDist = 1;
+	int m_reflectionDist = 1;
+	int m_refractionDist = 1;
+	bool m_raySorting = false;
+	bool m_adaptiveShadows = true;
+	double m_minThroughput = 0.0;
+	bool m_russianRoulette = false;
+	bool m_fresnelSelection = false;
+	double m_lightThreshold = 0.0;
+	int m_lightSampleCount = 0;
+	bool m_occluderCaching = true;
+	OccluderCache* m_occluderCache = nullptr;
+	int64_t m_softShadowPoints = 0;
+	int64_t m_softShadowRays = 0;
+	int64_t m_cappedSamples = 0;
+	int64_t m_tracedRays = 0;
+
+	std::vector<QueuedRay> m_primaryRays;
+	std::vector<QueuedRay> m_reflectionRays;
+	std::vector<QueuedRay> m_refractionRays;
+	std::vector<QueuedRay> m_activeRays;
+	std::vector<ShadowRay> m_shadowRays;
+	std::vector<ShadowGroup> m_shadowGroups;
+	std::vector<LightTree::LightSample> m_selectedLights;
+	std::vector<Intersection> m_intersections;
+	std::vector<char> m_occluded;
+	std::vector<char> m_capped;
+	std::vector<const ComponentShape*> m_cachedOccluders;
+	std::vector<uint64_t> m_sortKeys;
+	std::vector<QueuedRay> m_sortedRays;
+
+	static constexpr int MORTON_BITS = 10;
+	static constexpr int BATCH_BITS = 12;
+	static constexpr int BATCH_SIZE = 1 << BATCH_BITS;
+
+	bool isCancelled() const;
+
+	//spreads the low bits of the value so that two zero bits follow each of them
+	static uint32_t expandBits(uint32_t value);
+
+	//orders the queue by direction octant and then by the Morton code of the origin cell, 
+	//so consecutive rays start close to each other, head the same way and mostly test the same shapes
+	void sortRays(std::vector<QueuedRay>& rays);
+
+	//closest hit of every ray, the shapes are the outer loop so each one is applied to the whole queue at once
+	bool intersect(const std::vector<QueuedRay>& rays);
+
+	//only has to find out whether anything lies between the point and the light
+	bool occlude(std::vector<Color>& colors);
+
+	//adds the finished groups to their pixels and queues the rest of the budget for the ones in the penumbra
+	void resolveShadowGroups(std::vector<Color>& colors);
+
+	//queues the shadow rays from first to last of the group, their contributions are not yet weighted
+	void queueShadowRays(int group, int first, int last);
+
+	//queues the reflected or refracted ray unless its path ends here
+	void queueRay(std::vector<QueuedRay>& queue, const Ray& ray, const Color& weight, const QueuedRay& parent, const SamplePath& path, double throughput, double budget);
+
+	static Color getLightContribution(const Color& lightColor, const Vector& lightDir, const Vector& normal, const Vector& viewDir, const MaterialProperties& materialProperties);
+
+	//takes a batch of rays off the end of the queue, then intersects and shades it
+	bool traceBatch(std::vector<QueuedRay>& queue, std::vector<Color>& colors);
+
+	//adds the direct light of every hit and fills the shadow, reflection and refraction queues
+	void shade(const std::vector<QueuedRay>& rays, std::vector<Color>& colors, std::vector<double>* hitDistances);
+
+	void shadeHit(const QueuedRay& queuedRay, const Intersection& intersection, std::vector<Color>& colors);
+
+public:
+
+	//the occluder cache is the render thread's, so it stays warm from one tile to the next
+	WavefrontTracer(const RayTracer& rayTracer, const CompiledScene& scene, const CancellationToken& cancellationToken, OccluderCache& occluderCache);
+
+	WavefrontTracer(const WavefrontTracer& other) = default;
+
+	WavefrontTracer(WavefrontTracer&& other) = default;
+
+	WavefrontTracer& operator=(const WavefrontTracer& other) = default;
+
+	WavefrontTracer& operator=(WavefrontTracer&& other) = default;
+
+	~WavefrontTracer() = default;
+
+	//one color per ray, the hit distance of the ray is 0 if it missed, every ray and what it spawns may cost up to the budget, 
+	//returns false if the render was cancelled
+	bool trace(const std::vector<Ray>& rays, const std::vector<SamplePath>& paths, int recursion, double budget, std::vector<Color>& colors, std::vector<double>* hitDistances = nullptr);
+
+	//soft shadowed shading points and the shadow rays traced for them during the last trace
+	int64_t getSoftShadowPoints() const;
+
+	int64_t getSoftShadowRays() const;
+
+	//rays of the last trace whose budget lowered a ray count somewhere in their tree
+	int64_t getCappedSamples() const;
+
+	//rays intersected or tested for occlusion during the last trace, the queued rays and all they spawned
+	int64_t getTracedRays() const;
+};
@@ -0,0 +1,62 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int threadCount)
+{
+	for (int i = 0; i < std::max(1, threadCount); ++i)
+	{
+		m_threads.emplace_back(&WorkerPool::work, this);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopped = true;
+		m_tasks.clear();
+	}
+
+	m_condition.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+int WorkerPool::getThreadCount() const
+{
+	return static_cast<int>(m_threads.size());
+}
+
+void WorkerPool::submit(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+
+	m_condition.notify_one();
+}
+
+void WorkerPool::work()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stopped || !m_tasks.empty(); });
+
+			if (m_stopped)
+			{
+				return;
+			}
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+
+		task();
+	}
+}
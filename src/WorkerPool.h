@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//a fixed set of threads running tasks in the order they were submitted, shared by independent render jobs
+class WorkerPool
+{
+private:
+
+	std::vector<std::thread> m_threads;
+	std::deque<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_stopped = false;
+
+	void work();
+
+public:
+
+	explicit WorkerPool(int threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+
+	WorkerPool(const WorkerPool& other) = delete;
+
+	WorkerPool(WorkerPool&& other) = delete;
+
+	WorkerPool& operator=(const WorkerPool& other) = delete;
+
+	WorkerPool& operator=(WorkerPool&& other) = delete;
+
+	//tasks that have not started yet are dropped
+	~WorkerPool();
+
+	int getThreadCount() const;
+
+	void submit(std::function<void()> task);
+};
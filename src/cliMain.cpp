@@ -0,0 +1,13 @@
+#include "CommandLineRenderer.h"
+
+int main(int argc, char** argv)
+{
+	CommandLineRenderer renderer;
+
+	if (!renderer.parseArguments(argc, argv))
+	{
+		return 1;
+	}
+
+	return renderer.run();
+}